@@ -0,0 +1,27 @@
+#include "stm32f10x.h" // Device header
+#include "Bait.h"
+
+/**
+ * @brief  饵料余量检测初始化, 检测信号接PB1
+ * @param  无
+ * @retval 无
+ */
+void Bait_Init(void)
+{
+    RCC_APB2PeriphClockCmd(RCC_APB2Periph_GPIOB, ENABLE);
+    GPIO_InitTypeDef GPIO_InitStructure;
+    GPIO_InitStructure.GPIO_Mode = GPIO_Mode_IN_FLOATING;
+    GPIO_InitStructure.GPIO_Pin = GPIO_Pin_1;
+    GPIO_InitStructure.GPIO_Speed = GPIO_Speed_50MHz;
+    GPIO_Init(GPIOB, &GPIO_InitStructure);
+}
+
+/**
+ * @brief  读取饵料余量状态
+ * @param  无
+ * @retval 1:饵料不足(PB1为低电平) | 0:饵料充足
+ */
+uint8_t Bait_Low(void)
+{
+    return GPIO_ReadInputDataBit(GPIOB, GPIO_Pin_1) == 0;
+}
@@ -0,0 +1,7 @@
+#ifndef __BAIT_H
+#define __BAIT_H
+
+void Bait_Init(void);
+uint8_t Bait_Low(void);
+
+#endif
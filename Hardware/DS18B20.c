@@ -1,161 +1,537 @@
 #include "stm32f10x.h"
+#include <string.h>
 #include "Delay.h"
+#include "Tick.h"
+#include "OneWire.h"
+#include "Store.h"
+#include "DS18B20.h"
 
-#define DQ_H GPIO_SetBits(GPIOB, GPIO_Pin_0)
-#define DQ_L GPIO_ResetBits(GPIOB, GPIO_Pin_0)
-#define DQ_Get GPIO_ReadInputDataBit(GPIOB, GPIO_Pin_0)
+/*
+ * 单总线上的多个DS18B20: 上电时以搜索ROM找出全部传感器, 编号与ROM编码的对应关系(传感器表)保存在Flash,
+ * 更换或增加传感器后原有传感器的编号不变. 测温时以跳过ROM向全部传感器广播转换命令,
+ * 转换完成后以匹配ROM逐个读取, N个传感器只需一个转换周期.
+ * 分辨率9 - 12位可调, 转换时间随之为94 - 750ms; 调用者按用途切换分辨率, 转换是否完成以读时隙查询.
+ * 读取时读出全部9字节暂存器并做CRC-8校验, 校验失败(位时隙受中断干扰等)时重试, 各类错误计入DS18B20_Stat.
+ * 读取可异步进行(DS18B20_ReadStart/ReadDone/ReadEnd): USART2传输方式下读暂存器的152个时隙由中断收发, 调用者不必等待;
+ * GPIO传输方式下每次调用至多进行一次传输(首次读取或一次重试), 调用者可在两次调用之间让出.
+ * 搜索总线同样可分步进行(DS18B20_ScanStart/ScanStep): 每步只搜索一个ROM、保存传感器表或写一次配置.
+ */
+
+// ROM命令
+#define DS18B20_SEARCH_ROM 0xF0
+#define DS18B20_MATCH_ROM 0x55
+#define DS18B20_SKIP_ROM 0xCC
+// 功能命令
+#define DS18B20_CONVERT_T 0x44
+#define DS18B20_READ_SCRATCHPAD 0xBE
+#define DS18B20_WRITE_SCRATCHPAD 0x4E
+#define DS18B20_COPY_SCRATCHPAD 0x48
+
+#define DS18B20_FAMILY 0x28 // DS18B20的家族码(ROM编码第0字节)
+
+// 暂存器中的报警上下限(本程序不使用报警搜索, 写入出厂值)
+#define DS18B20_TH 0x4B
+#define DS18B20_TL 0x46
+
+#define DS18B20_RETRY 2 // 读取失败时的重试次数
+
+// 读暂存器结果
+#define DS18B20_READ_OK 0     // 成功
+#define DS18B20_READ_CRC 1    // 校验失败
+#define DS18B20_READ_RESET 2  // 复位无存在脉冲或传输失败
+#define DS18B20_READ_ABSENT 3 // 该传感器未应答
+#define DS18B20_READ_BUSY 4   // 传输中
+
+// 搜索总线的步骤
+#define DS18B20_SCAN_SEARCH 0 // 搜索下一个ROM
+#define DS18B20_SCAN_SAVE 1   // 传感器表写入Flash
+#define DS18B20_SCAN_CONFIG 2 // 写入默认分辨率并开始复制到EEPROM
+#define DS18B20_SCAN_COPY 3   // 等待EEPROM写入完成(至多10ms)
+#define DS18B20_SCAN_DONE 4   // 结束
+
+typedef struct
+{
+	uint8_t Count;                // 已分配编号的传感器数
+	uint8_t Rom[DS18B20_MAX][8];  // 各编号传感器的ROM编码
+} DS18B20_TableTypeDef;
+
+static DS18B20_TableTypeDef DS18B20_Table; // 传感器表
+static uint8_t DS18B20_Bits = 0;            // 全部传感器当前的分辨率, 0表示未知(需重新写入)
+
+static struct
+{
+	uint8_t Index;   // 传感器编号
+	uint8_t Try;     // 已重试次数
+	uint8_t Result;  // 本次传输的结果, DS18B20_READ_*
+	uint8_t Buf[19]; // 匹配ROM + 读暂存器指令 + 9字节暂存器, 传输结束前须保持有效
+} DS18B20_Read; // 正在进行的读取
+
+static struct
+{
+	uint8_t Step;                  // 当前步骤, DS18B20_SCAN_*
+	uint8_t Last;                  // 搜索ROM上次选0方向的最后一个分歧位
+	uint8_t Count;                 // 本次已找到的传感器数
+	uint8_t Rom[8];                // 上次找到的ROM编码
+	uint8_t Found[DS18B20_MAX][8]; // 本次找到的传感器
+	uint32_t Tick;                 // 开始复制到EEPROM的时刻, 毫秒
+} DS18B20_ScanSt; // 正在进行的搜索
+
+DS18B20_StatTypeDef DS18B20_Stat = {0}; // 总线错误统计
+
+// CRC-8查表: 余式低4位、高4位各自对应的值
+static const uint8_t DS18B20_CRC8_Lo[16] = {0x00, 0x5E, 0xBC, 0xE2, 0x61, 0x3F, 0xDD, 0x83, 0xC2, 0x9C, 0x7E, 0x20, 0xA3, 0xFD, 0x1F, 0x41};
+static const uint8_t DS18B20_CRC8_Hi[16] = {0x00, 0x9D, 0x23, 0xBE, 0x46, 0xDB, 0x65, 0xF8, 0x8C, 0x11, 0xAF, 0x32, 0xCA, 0x57, 0xE9, 0x74};
 
 /**
- * @brief  初始化DS18B20通信IO口。PB0
+ * @brief  CRC-8校验(多项式X^8+X^5+X^4+1, 低位在前), 每字节查两次16项的表。
+ * @param  Data 数据
+ * @param  Len 长度
+ * @retval 校验值, 对含校验字节的完整数据计算时结果为0
+ */
+static uint8_t DS18B20_CRC8(const uint8_t *Data, uint8_t Len)
+{
+	uint8_t CRC8 = 0;
+	while (Len--)
+	{
+		CRC8 ^= *Data++;
+		CRC8 = DS18B20_CRC8_Lo[CRC8 & 0x0F] ^ DS18B20_CRC8_Hi[CRC8 >> 4];
+	}
+	return CRC8;
+}
+
+/**
+ * @brief  复位总线并检测存在脉冲, 无应答时计入统计。
  * @param  无
- * @retval 无
+ * @retval 1:总线上无器件应答 | 0:有器件应答
  */
-void DS18B20_Init(void)
+static uint8_t DS18B20_Reset(void)
 {
-	RCC_APB2PeriphClockCmd(RCC_APB2Periph_GPIOB, ENABLE);
+	if (OneWire_Reset())
+	{
+		DS18B20_Stat.Presence++;
+		return 1;
+	}
+	return 0;
+}
 
-	GPIO_InitTypeDef GPIO_InitStructure;
-	GPIO_InitStructure.GPIO_Mode = GPIO_Mode_Out_PP;
-	GPIO_InitStructure.GPIO_Pin = GPIO_Pin_0;
-	GPIO_InitStructure.GPIO_Speed = GPIO_Speed_50MHz;
-	GPIO_Init(GPIOB, &GPIO_InitStructure);
+/**
+ * @brief  搜索ROM, 按上次的分歧位置找出下一个器件(逐位读出全部器件ROM编码的该位及其反码, 写入选择的方向)。
+ * @param  Rom ROM编码, 输入上次找到的编码, 输出本次找到的编码
+ * @param  Last 上次选0方向的最后一个分歧位(1 - 64), 首次搜索时为0; 输出本次的值, 为0表示已找到全部器件
+ * @retval 1:总线上无器件应答 | 0:找到一个器件
+ */
+static uint8_t DS18B20_Search(uint8_t *Rom, uint8_t *Last)
+{
+	uint8_t i, Bit, Cmp, Dir, Fork = 0;
+
+	if (DS18B20_Reset())
+		return 1;
+	OneWire_WriteByte(DS18B20_SEARCH_ROM);
+	for (i = 1; i <= 64; i++)
+	{
+		Bit = OneWire_ReadBit();
+		Cmp = OneWire_ReadBit();
+		if (Bit && Cmp) // 无器件应答
+			return 1;
+		if (Bit != Cmp) // 全部器件该位相同
+			Dir = Bit;
+		else // 分歧: 上次分歧位之前沿用上次的方向, 在上次分歧位改走1, 之后先走0
+		{
+			if (i < *Last)
+				Dir = (Rom[(i - 1) / 8] >> ((i - 1) % 8)) & 0x01;
+			else
+				Dir = (i == *Last);
+			if (Dir == 0)
+				Fork = i;
+		}
+		if (Dir)
+			Rom[(i - 1) / 8] |= 1 << ((i - 1) % 8);
+		else
+			Rom[(i - 1) / 8] &= ~(1 << ((i - 1) % 8));
+		OneWire_WriteBit(Dir);
+	}
+	*Last = Fork;
+	return 0;
 }
 
 /**
- * @brief  初始化通信口为输出模式。PB0
- * @param  无
- * @retval 无
+ * @brief  以跳过ROM向全部传感器写入配置寄存器(及报警上下限)。
+ * @param  Bits 分辨率, 9 - 12
+ * @retval 1:总线上无器件应答 | 0:成功
  */
-void DS18B20_Output(void)
+static uint8_t DS18B20_WriteConfig(uint8_t Bits)
 {
-	GPIO_InitTypeDef GPIO_InitStructure;
-	GPIO_InitStructure.GPIO_Mode = GPIO_Mode_Out_PP;
-	GPIO_InitStructure.GPIO_Pin = GPIO_Pin_0;
-	GPIO_InitStructure.GPIO_Speed = GPIO_Speed_50MHz;
-	GPIO_Init(GPIOB, &GPIO_InitStructure);
+	uint8_t Cmd[5] = {DS18B20_SKIP_ROM, DS18B20_WRITE_SCRATCHPAD, DS18B20_TH, DS18B20_TL};
+
+	Cmd[4] = ((Bits - 9) << 5) | 0x1F; // 配置寄存器: 第6、5位为分辨率, 其余位固定为1
+	if (DS18B20_Reset())
+		return 1;
+	return OneWire_Touch(Cmd, sizeof(Cmd));
 }
 
 /**
- * @brief  初始化通信口为输入模式。PB0
+ * @brief  开始把全部传感器的暂存器配置复制到其EEPROM, 作为上电后的配置, 立即返回。
+ *         写入至多10ms, 期间读时隙应答0。
  * @param  无
- * @retval 无
+ * @retval 1:总线上无器件应答 | 0:已开始
  */
-void DS18B20_Input(void)
+static uint8_t DS18B20_CopyConfig(void)
 {
-	GPIO_InitTypeDef GPIO_InitStructure;
-	GPIO_InitStructure.GPIO_Mode = GPIO_Mode_IPU;
-	GPIO_InitStructure.GPIO_Pin = GPIO_Pin_0;
-	GPIO_Init(GPIOB, &GPIO_InitStructure);
+	if (DS18B20_Reset())
+		return 1;
+	OneWire_WriteByte(DS18B20_SKIP_ROM);
+	OneWire_WriteByte(DS18B20_COPY_SCRATCHPAD);
+	return 0;
 }
 
 /**
- * @brief  复位DS18B20。
+ * @brief  按本次找到的传感器更新传感器表。
+ *         表中已有的传感器保持原编号; 新发现的传感器占用空闲编号, 无空闲编号时替换本次未找到的传感器。
  * @param  无
- * @retval Resetflag 复位标志，当DS18B20出现故障或未连接时返回值为1，反之为0
+ * @retval 1:传感器表有变化 | 0:无变化
  */
-uint8_t DS18B20_Reset(void)
+static uint8_t DS18B20_Merge(void)
 {
-	uint8_t Resetflag = 1;
-	DS18B20_Output();
-	DQ_H;
-	Delay_us(5);
+	uint8_t n = DS18B20_ScanSt.Count, i, j, Present = 0, New = 0, Changed = 0;
 
-	DQ_L;
-	Delay_us(480);
-	DQ_H;
-	Delay_us(60);
-	DS18B20_Input();
-	Resetflag = DQ_Get;
-	Delay_us(480);
-	DS18B20_Output();
-	DQ_H;
-	return Resetflag;
+	// 已在表中的传感器
+	for (i = 0; i < n; i++)
+	{
+		for (j = 0; j < DS18B20_Table.Count; j++)
+			if (memcmp(DS18B20_Table.Rom[j], DS18B20_ScanSt.Found[i], 8) == 0)
+				break;
+		if (j < DS18B20_Table.Count)
+			Present |= 1 << j;
+		else
+			New |= 1 << i;
+	}
+	// 新传感器
+	for (i = 0; i < n; i++)
+	{
+		if (!(New & (1 << i)))
+			continue;
+		if (DS18B20_Table.Count < DS18B20_MAX)
+			j = DS18B20_Table.Count++;
+		else
+			for (j = 0; Present & (1 << j); j++)
+				;
+		memcpy(DS18B20_Table.Rom[j], DS18B20_ScanSt.Found[i], 8);
+		Present |= 1 << j;
+		Changed = 1;
+	}
+	return Changed;
 }
 
 /**
- * @brief  向DS18B20写数据。
- * @param  data 数据
+ * @brief  开始搜索总线上的全部DS18B20, 之后反复调用DS18B20_ScanStep直到返回1, 其间不得访问总线。
+ * @param  无
  * @retval 无
  */
-void DS18B20_WriteData(uint8_t data)
+void DS18B20_ScanStart(void)
+{
+	DS18B20_ScanSt.Step = DS18B20_SCAN_SEARCH;
+	DS18B20_ScanSt.Last = 0;
+	DS18B20_ScanSt.Count = 0;
+}
+
+/**
+ * @brief  执行搜索总线的一步: 搜索一个ROM; 全部找到后更新传感器表(见DS18B20_Merge),
+ *         表有变化时再依次把表写入Flash、把默认分辨率写入各传感器的暂存器并复制到EEPROM,
+ *         使新换上的传感器上电配置一致; EEPROM只在此时写入, 运行中切换分辨率不会磨损EEPROM。
+ *         搜索后分辨率视为未知, 下次DS18B20_SetResolution时重新写入(重新接好的传感器已恢复为上电配置)。
+ * @param  无
+ * @retval 1:搜索结束 | 0:还有后续步骤
+ */
+uint8_t DS18B20_ScanStep(void)
 {
-	for (uint8_t i = 0; i < 8; i++)
+	switch (DS18B20_ScanSt.Step)
 	{
-		DS18B20_Output();
-		DQ_L;
-		Delay_us(2);
-		if (data & 0x01)
+	case DS18B20_SCAN_SEARCH:
+		if (!DS18B20_Search(DS18B20_ScanSt.Rom, &DS18B20_ScanSt.Last))
 		{
-			DQ_H;
+			if ((DS18B20_ScanSt.Rom[0] == DS18B20_FAMILY) && (DS18B20_CRC8(DS18B20_ScanSt.Rom, 8) == 0))
+				memcpy(DS18B20_ScanSt.Found[DS18B20_ScanSt.Count++], DS18B20_ScanSt.Rom, 8);
+			if (DS18B20_ScanSt.Last && (DS18B20_ScanSt.Count < DS18B20_MAX))
+				return 0;
 		}
-		else
+		DS18B20_Bits = 0;
+		DS18B20_ScanSt.Step = DS18B20_Merge() ? DS18B20_SCAN_SAVE : DS18B20_SCAN_DONE;
+		return DS18B20_ScanSt.Step == DS18B20_SCAN_DONE;
+
+	case DS18B20_SCAN_SAVE:
+		Store_Save(&DS18B20_Table, sizeof(DS18B20_Table));
+		DS18B20_ScanSt.Step = DS18B20_SCAN_CONFIG;
+		return 0;
+
+	case DS18B20_SCAN_CONFIG:
+		if (DS18B20_WriteConfig(DS18B20_RES_DEFAULT) || DS18B20_CopyConfig())
 		{
-			DQ_L;
+			DS18B20_ScanSt.Step = DS18B20_SCAN_DONE;
+			return 1;
 		}
-		Delay_us(60);
-		DQ_H;
-		data = data >> 1;
+		DS18B20_ScanSt.Tick = Tick_Get();
+		DS18B20_ScanSt.Step = DS18B20_SCAN_COPY;
+		return 0;
+
+	case DS18B20_SCAN_COPY:
+		if (!OneWire_ReadBit() && (Tick_Get() - DS18B20_ScanSt.Tick < 10)) // 写入期间读时隙应答0
+			return 0;
+		DS18B20_ScanSt.Step = DS18B20_SCAN_DONE;
+		return 1;
+
+	default:
+		return 1;
+	}
+}
+
+/**
+ * @brief  搜索总线上的全部DS18B20并更新传感器表(阻塞), 步骤见DS18B20_ScanStep。
+ * @param  无
+ * @retval 本次找到的传感器数
+ */
+uint8_t DS18B20_Scan(void)
+{
+	DS18B20_ScanStart();
+	while (!DS18B20_ScanStep());
+	return DS18B20_ScanSt.Count;
+}
+
+/**
+ * @brief  初始化DS18B20: 初始化总线, 读取传感器表并搜索总线上的传感器。PB0
+ * @param  无
+ * @retval 找到的传感器数
+ */
+uint8_t DS18B20_Init(void)
+{
+	OneWire_Init();
+	if (Store_Load(&DS18B20_Table, sizeof(DS18B20_Table)) || (DS18B20_Table.Count > DS18B20_MAX))
+		DS18B20_Table.Count = 0;
+	return DS18B20_Scan();
+}
+
+/**
+ * @brief  获取已分配编号的传感器数, 编号为0 - 该值-1。
+ * @param  无
+ * @retval 传感器数
+ */
+uint8_t DS18B20_Count(void)
+{
+	return DS18B20_Table.Count;
+}
+
+/**
+ * @brief  设置全部传感器的分辨率(只写暂存器, 掉电后恢复为EEPROM中的默认分辨率)。与当前分辨率相同时不访问总线。
+ * @param  Bits 分辨率
+ *   @arg  9: 0.5℃, 转换至多94ms
+ *   @arg  10: 0.25℃, 转换至多188ms
+ *   @arg  11: 0.125℃, 转换至多375ms
+ *   @arg  12: 0.0625℃, 转换至多750ms
+ * @retval 1:参数无效或总线上无器件应答 | 0:成功
+ */
+uint8_t DS18B20_SetResolution(uint8_t Bits)
+{
+	if ((Bits < 9) || (Bits > 12))
+		return 1;
+	if (Bits == DS18B20_Bits)
+		return 0;
+	if (DS18B20_WriteConfig(Bits))
+	{
+		DS18B20_Bits = 0;
+		return 1;
 	}
+	DS18B20_Bits = Bits;
+	return 0;
 }
 
 /**
- * @brief  读DS18B20寄存器数据。
+ * @brief  获取当前分辨率下温度转换的最长时间, 作为查询转换完成的超时。分辨率未知时按12位计。
  * @param  无
- * @retval data
+ * @retval 转换时间, 毫秒
  */
-uint8_t DS18B20_ReadData(void)
+uint16_t DS18B20_ConvertTime(void)
 {
-	uint8_t data = 0;
+	static const uint16_t Time[4] = {94, 188, 375, 750};
+	return DS18B20_Bits ? Time[DS18B20_Bits - 9] : 750;
+}
 
-	for (uint8_t i = 0; i < 8; i++)
+/**
+ * @brief  向总线上全部传感器广播温度转换命令, 立即返回。
+ * @param  无
+ * @retval Resetflag 复位标志，总线上无器件应答时返回值为1，反之为0
+ */
+uint8_t DS18B20_StartConvert(void)
+{
+	if (DS18B20_Reset()) // 复位
 	{
-		data = data >> 1;
-		DS18B20_Output();
-		DQ_L;
-		Delay_us(2);
-		DQ_H;
-		Delay_us(2);
-		DS18B20_Input();
-		if (DQ_Get)
-			data |= 0x80;
-		Delay_us(60);
+		DS18B20_Bits = 0; // 总线断开期间传感器可能已掉电复位
+		return 1;
 	}
-	return data;
+	OneWire_WriteByte(DS18B20_SKIP_ROM); // 跳过ROM, 全部器件执行随后的命令
+	OneWire_WriteByte(DS18B20_CONVERT_T); // 启动温度转换
+	return 0;
 }
 
 /**
- * @brief  从DS18B20读取温度值。
+ * @brief  查询温度转换是否完成。
+ *         转换期间DS18B20对读时隙应答0, 全部传感器完成后读到1(仅适用于外部供电方式)。
  * @param  无
- * @retval Temperature 温度值，范围: -55℃到+125℃
+ * @retval 1:转换完成 | 0:转换中
  */
-float DS18B20_ReadTemp(void)
+uint8_t DS18B20_ConvertDone(void)
 {
-	uint8_t DL, DH;
+	return OneWire_ReadBit();
+}
+
+/**
+ * @brief  以匹配ROM开始读出当前传感器的9字节暂存器: 复位后启动一次传输, 立即返回。
+ * @param  无
+ * @retval DS18B20_READ_BUSY:传输已开始 | DS18B20_READ_RESET
+ */
+static uint8_t DS18B20_ReadBegin(void)
+{
+	DS18B20_Stat.Read++;
+	// 匹配ROM(只有编码相同的器件执行随后的命令) + 读取暂存器指令 + 9个读字节, 一次传输
+	DS18B20_Read.Buf[0] = DS18B20_MATCH_ROM;
+	memcpy(&DS18B20_Read.Buf[1], DS18B20_Table.Rom[DS18B20_Read.Index], 8);
+	DS18B20_Read.Buf[9] = DS18B20_READ_SCRATCHPAD;
+	memset(&DS18B20_Read.Buf[10], 0xFF, 9);
+	if (DS18B20_Reset()) // 复位
+		return DS18B20_READ_RESET;
+	OneWire_TouchStart(DS18B20_Read.Buf, sizeof(DS18B20_Read.Buf));
+	return DS18B20_READ_BUSY;
+}
+
+/**
+ * @brief  传输结束后校验读出的暂存器。
+ * @param  无
+ * @retval DS18B20_READ_OK | DS18B20_READ_CRC | DS18B20_READ_RESET | DS18B20_READ_ABSENT
+ */
+static uint8_t DS18B20_ReadCheck(void)
+{
+	uint8_t *Scratchpad = &DS18B20_Read.Buf[10];
+	uint8_t i, Ones = 0xFF;
+
+	if (OneWire_TouchEnd())
+		return DS18B20_READ_RESET;
+	for (i = 0; i < 9; i++)
+		Ones &= Scratchpad[i];
+	if (Ones == 0xFF) // 无器件驱动总线, 读到上拉电平
+	{
+		DS18B20_Stat.Presence++;
+		return DS18B20_READ_ABSENT;
+	}
+	// 配置寄存器的低5位与最高位固定为1, 可排除总线短路时全0数据恰好通过校验的情况
+	if ((DS18B20_CRC8(Scratchpad, 9) != 0) || ((Scratchpad[4] & 0x9F) != 0x1F))
+	{
+		DS18B20_Stat.Crc++;
+		return DS18B20_READ_CRC;
+	}
+	return DS18B20_READ_OK;
+}
+
+/**
+ * @brief  开始以匹配ROM读取指定传感器暂存器中的转换结果, 立即返回。
+ *         之后以DS18B20_ReadDone查询, 结束后以DS18B20_ReadEnd取结果, 其间不得访问总线。
+ * @param  Index 传感器编号
+ * @retval 1:编号无效 | 0:已开始
+ */
+uint8_t DS18B20_ReadStart(uint8_t Index)
+{
+	if (Index >= DS18B20_Table.Count)
+		return 1;
+	DS18B20_Read.Index = Index;
+	DS18B20_Read.Try = 0;
+	DS18B20_Read.Result = DS18B20_ReadBegin();
+	return 0;
+}
+
+/**
+ * @brief  查询读取是否结束。传输结束时校验, 校验失败或复位无应答时重新开始传输, 至多重试DS18B20_RETRY次;
+ *         该传感器未应答(读到全1)说明其已断开, 不重试。每次调用至多开始一次传输。
+ * @param  无
+ * @retval 1:结束 | 0:传输中
+ */
+uint8_t DS18B20_ReadDone(void)
+{
+	while (1)
+	{
+		if (DS18B20_Read.Result == DS18B20_READ_BUSY)
+		{
+			if (!OneWire_TouchDone())
+				return 0;
+			DS18B20_Read.Result = DS18B20_ReadCheck();
+		}
+		if ((DS18B20_Read.Result == DS18B20_READ_OK) || (DS18B20_Read.Result == DS18B20_READ_ABSENT) ||
+		    (DS18B20_Read.Try >= DS18B20_RETRY))
+			return 1;
+		DS18B20_Read.Try++;
+		DS18B20_Stat.Retry++;
+		DS18B20_Read.Result = DS18B20_ReadBegin();
+		if (DS18B20_Read.Result == DS18B20_READ_BUSY)
+			return 0; // 重试已开始, GPIO传输方式下此时已传输完毕, 留到下次调用再校验
+	}
+}
+
+/**
+ * @brief  取DS18B20_ReadStart开始的读取结果, DS18B20_ReadDone返回1后调用。
+ * @param  Temperature 温度值输出, 单位0.01℃，范围: -5500到+12500
+ * @retval 1:总线无应答、该传感器未应答或多次校验失败 | 0:成功
+ */
+uint8_t DS18B20_ReadEnd(int16_t *Temperature)
+{
+	const uint8_t *Scratchpad = &DS18B20_Read.Buf[10];
 	uint16_t data;
 	uint8_t Tflag = 0; // 正负温度标志. 0:正 | 1:负
-	float Temperature = 0;
-	DS18B20_Reset();		 // 复位
-	DS18B20_WriteData(0xCC); // 跳过ROM检测
-	DS18B20_WriteData(0x44); // 启动温度转换
-	Delay_ms(750);			 // 延时，等待转换完成
-	DS18B20_Reset();		 // 复位
-	DS18B20_WriteData(0xCC); // 跳过ROM检测
-	DS18B20_WriteData(0xBE); // 读取暂存器指令
-	DL = DS18B20_ReadData(); // 读温度低位
-	DH = DS18B20_ReadData(); // 读温度高位
-	data = DH;
+	if (DS18B20_Read.Result != DS18B20_READ_OK)
+	{
+		DS18B20_Stat.Fail++;
+		return 1;
+	}
+	data = Scratchpad[1]; // 温度高位
 	data = data << 8;
-	data |= DL;
+	data |= Scratchpad[0]; // 温度低位
+	data &= ~((1 << (3 - ((Scratchpad[4] >> 5) & 0x03))) - 1); // 按该传感器配置的分辨率清零无定义的低位
 	// 读取高五位判断温度的正负，高5位全为0表示为正，全为1表示负
 	if ((data & 0xF800) == 0xF800) // 0xF800: 1111 1000
 	{
 		data = ~data + 0x01;
 		Tflag = 1;
 	}
-	Temperature = data * 0.0625;
+	*Temperature = (data * 25 + 2) / 4; // 1/16℃ -> 0.01℃, 四舍五入
 	if (Tflag)
 	{
-		Temperature = -Temperature;
+		*Temperature = -*Temperature;
 	}
+	return 0;
+}
+
+/**
+ * @brief  以匹配ROM读取指定传感器暂存器中的转换结果(阻塞), 重试规则同DS18B20_ReadDone。
+ * @param  Index 传感器编号
+ * @param  Temperature 温度值输出, 单位0.01℃，范围: -5500到+12500
+ * @retval 1:编号无效、总线无应答、该传感器未应答或多次校验失败 | 0:成功
+ */
+uint8_t DS18B20_ReadResult(uint8_t Index, int16_t *Temperature)
+{
+	if (DS18B20_ReadStart(Index))
+		return 1;
+	while (!DS18B20_ReadDone());
+	return DS18B20_ReadEnd(Temperature);
+}
+
+/**
+ * @brief  从0号传感器读取温度值(阻塞, 查询等待转换完成, 至多为当前分辨率的转换时间)。
+ * @param  无
+ * @retval Temperature 温度值, 单位0.01℃，范围: -5500到+12500
+ */
+int16_t DS18B20_ReadTemp(void)
+{
+	int16_t Temperature = 0;
+	uint16_t i;
+	if (DS18B20_StartConvert())
+		return Temperature;
+	for (i = 0; (i < DS18B20_ConvertTime()) && !DS18B20_ConvertDone(); i++)
+		Delay_ms(1); // 等待转换完成
+	DS18B20_ReadResult(0, &Temperature);
 	return Temperature;
 }
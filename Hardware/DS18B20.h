@@ -1,8 +1,34 @@
 #ifndef __DS18B20_H
 #define __DS18B20_H
 
-void DS18B20_Init(void);
-uint8_t DS18B20_Reset(void);
-float DS18B20_ReadTemp(void);
+#define DS18B20_MAX 4 // 总线上最多管理的传感器数
+
+#define DS18B20_RES_DEFAULT 12 // 上电默认分辨率(写入新传感器的EEPROM), 位
+
+typedef struct
+{
+	uint32_t Read;     // 读暂存器次数(含重试)
+	uint32_t Crc;      // CRC校验失败次数
+	uint32_t Presence; // 无应答次数(复位无存在脉冲或被选中的传感器未应答)
+	uint32_t Retry;    // 重试次数
+	uint32_t Fail;     // 重试后仍失败的读取次数
+} DS18B20_StatTypeDef;
+
+extern DS18B20_StatTypeDef DS18B20_Stat;
+
+uint8_t DS18B20_Init(void);
+uint8_t DS18B20_Scan(void);
+void DS18B20_ScanStart(void);
+uint8_t DS18B20_ScanStep(void);
+uint8_t DS18B20_Count(void);
+uint8_t DS18B20_SetResolution(uint8_t Bits);
+uint16_t DS18B20_ConvertTime(void);
+uint8_t DS18B20_StartConvert(void);
+uint8_t DS18B20_ConvertDone(void);
+uint8_t DS18B20_ReadStart(uint8_t Index);
+uint8_t DS18B20_ReadDone(void);
+uint8_t DS18B20_ReadEnd(int16_t *Temperature);
+uint8_t DS18B20_ReadResult(uint8_t Index, int16_t *Temperature);
+int16_t DS18B20_ReadTemp(void);
 
 #endif
@@ -1,58 +1,66 @@
 #include "stm32f10x.h" // Device header
-#include "Delay.h"
+#include "Timer.h"
+#include "Key.h"
 
+#define KEY_NUM 6          // 按键数
+#define KEY_FILTER 4       // 消抖积分上限, 连续4次(20ms)采样一致才改变状态
+#define KEY_LONG_TIME 200  // 长按判定时间, 单位5ms
+#define KEY_REPEAT_TIME 20 // 连发间隔, 单位5ms
+#define KEY_FIFO_LEN 16    // 事件队列长度, 须为2的幂
+
+// 按键引脚与键码
+static const uint16_t Key_Pin[KEY_NUM] = {GPIO_Pin_5, GPIO_Pin_6, GPIO_Pin_7, GPIO_Pin_10, GPIO_Pin_11, GPIO_Pin_12};
+static const uint8_t Key_Code[KEY_NUM] = {5, 4, 6, 8, 2, 1};
+
+static uint8_t Key_Filter[KEY_NUM]; // 消抖积分值, 0~KEY_FILTER
+static uint8_t Key_State[KEY_NUM];  // 消抖后状态. 1:按下 | 0:松开
+static uint16_t Key_Hold[KEY_NUM];  // 按住时长, 单位5ms
+
+// 事件队列: In仅由扫描中断写, Out仅由主循环写, 无需关中断
+static uint8_t Key_Fifo[KEY_FIFO_LEN];
+static volatile uint8_t Key_FifoIn = 0;
+static volatile uint8_t Key_FifoOut = 0;
+uint32_t Key_Lost = 0; // 队列满丢弃的事件数
+
+/**
+ * @brief  按键初始化, 配置按键引脚, 启动5ms按键扫描定时器
+ * @param  无
+ * @retval 无
+ */
 void Key_Init(void)
 {
     RCC_APB2PeriphClockCmd(RCC_APB2Periph_GPIOB, ENABLE);
-    RCC_APB2PeriphClockCmd(RCC_APB2Periph_AFIO, ENABLE);
     GPIO_InitTypeDef GPIO_InitStructure;
     GPIO_InitStructure.GPIO_Mode = GPIO_Mode_IPU;
     GPIO_InitStructure.GPIO_Pin = GPIO_Pin_5 | GPIO_Pin_6 | GPIO_Pin_7 | GPIO_Pin_10 | GPIO_Pin_11 | GPIO_Pin_12;
     GPIO_InitStructure.GPIO_Speed = GPIO_Speed_50MHz;
     GPIO_Init(GPIOB, &GPIO_InitStructure);
 
-    GPIO_InitStructure.GPIO_Mode = GPIO_Mode_IN_FLOATING;
-    GPIO_InitStructure.GPIO_Pin = GPIO_Pin_1;
-    GPIO_InitStructure.GPIO_Speed = GPIO_Speed_50MHz;
-    GPIO_Init(GPIOB, &GPIO_InitStructure);
-
-    GPIO_EXTILineConfig(GPIO_PortSourceGPIOB, GPIO_PinSource5);
-    GPIO_EXTILineConfig(GPIO_PortSourceGPIOB, GPIO_PinSource6);
-    GPIO_EXTILineConfig(GPIO_PortSourceGPIOB, GPIO_PinSource7);
-    GPIO_EXTILineConfig(GPIO_PortSourceGPIOB, GPIO_PinSource10);
-    GPIO_EXTILineConfig(GPIO_PortSourceGPIOB, GPIO_PinSource11);
-    GPIO_EXTILineConfig(GPIO_PortSourceGPIOB, GPIO_PinSource12);
-
-    EXTI_InitTypeDef EXTI_InitStructure;
-    EXTI_InitStructure.EXTI_Line = EXTI_Line5 | EXTI_Line6 | EXTI_Line7 | EXTI_Line10 | EXTI_Line11 | EXTI_Line12;
-    EXTI_InitStructure.EXTI_LineCmd = ENABLE;
-    EXTI_InitStructure.EXTI_Mode = EXTI_Mode_Interrupt;
-    EXTI_InitStructure.EXTI_Trigger = EXTI_Trigger_Falling;
-    EXTI_Init(&EXTI_InitStructure);
-
-    NVIC_PriorityGroupConfig(NVIC_PriorityGroup_2);
+    Timer_Init();
+}
 
-    NVIC_InitTypeDef NVIC_InitStructure;
-    NVIC_InitStructure.NVIC_IRQChannel = EXTI9_5_IRQn;
-    NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
-    NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = 1;
-    NVIC_InitStructure.NVIC_IRQChannelSubPriority = 1;
-    NVIC_Init(&NVIC_InitStructure);
+/**
+ * @brief  写入一个按键事件, 队列满时丢弃并计数
+ * @param  Event 按键事件, 事件类型|键码
+ * @retval 无
+ */
+static void Key_Put(uint8_t Event)
+{
+    uint8_t In = Key_FifoIn;
 
-    NVIC_InitStructure.NVIC_IRQChannel = EXTI15_10_IRQn;
-    NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
-    NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = 1;
-    NVIC_InitStructure.NVIC_IRQChannelSubPriority = 2;
-    NVIC_Init(&NVIC_InitStructure);
+    if ((uint8_t)(In - Key_FifoOut) >= KEY_FIFO_LEN)
+    {
+        Key_Lost++;
+        return;
+    }
+    Key_Fifo[In & (KEY_FIFO_LEN - 1)] = Event;
+    Key_FifoIn = In + 1;
 }
 
-uint8_t KeyNum = 0;
-
 /**
- * @brief  读取按键键码
+ * @brief  读取一个按键事件
  * @param  无
- * @retval 键码值。
- * KeyNum保存键码值, 无按键动作时为0。
+ * @retval 按键事件, 无事件时为0. 用KEY_TYPE()取事件类型, KEY_CODE()取键码:
  * PB5 菜单键、确认键, 键码:5 |
  * PB6 左方向键, 键码:4 |
  * PB7 右方向键, 键码:6 |
@@ -60,88 +68,75 @@ uint8_t KeyNum = 0;
  * PB11 下方向键, 键码:2 |
  * PB12 返回键, 键码:1
  */
-int8_t GetKeyNum(void)
+uint8_t Key_GetEvent(void)
 {
-    uint8_t Temp;
-    Temp = KeyNum;
-    KeyNum = 0;
-    return Temp;
+    uint8_t Out = Key_FifoOut;
+    uint8_t Event;
+
+    if (Out == Key_FifoIn)
+        return 0;
+    Event = Key_Fifo[Out & (KEY_FIFO_LEN - 1)];
+    Key_FifoOut = Out + 1;
+    return Event;
 }
 
-void EXTI9_5_IRQHandler(void)
+/**
+ * @brief  按键扫描, 每5ms在定时器中断中调用一次.
+ *         按下时积分值加1, 松开时减1, 积分到上限或归零时才改变按键状态,
+ *         状态改变时产生按下/松开事件, 按住期间产生长按与连发事件
+ * @param  无
+ * @retval 无
+ */
+static void Key_Scan(void)
 {
-    // PB5 菜单键、确认键,键码:5
-    if (EXTI_GetITStatus(EXTI_Line5) == SET)
+    uint16_t Input = GPIO_ReadInputData(GPIOB);
+    uint8_t i;
+
+    for (i = 0; i < KEY_NUM; i++)
     {
-        if (GPIO_ReadInputDataBit(GPIOB, GPIO_Pin_5) == 0)
+        if ((Input & Key_Pin[i]) == 0) // 低电平为按下
         {
-            while (GPIO_ReadInputDataBit(GPIOB, GPIO_Pin_5) == 0)
-                ;
-            KeyNum = 5;
+            if (Key_Filter[i] < KEY_FILTER)
+                Key_Filter[i]++;
         }
-        EXTI_ClearITPendingBit(EXTI_Line5);
-    }
-
-    // PB6 左方向键,键码:4
-    if (EXTI_GetITStatus(EXTI_Line6) == SET)
-    {
-        if (GPIO_ReadInputDataBit(GPIOB, GPIO_Pin_6) == 0)
+        else if (Key_Filter[i] > 0)
         {
-            while (GPIO_ReadInputDataBit(GPIOB, GPIO_Pin_6) == 0)
-                ;
-            KeyNum = 4;
+            Key_Filter[i]--;
         }
-        EXTI_ClearITPendingBit(EXTI_Line6);
-    }
 
-    // PB7 右方向键,键码:6
-    if (EXTI_GetITStatus(EXTI_Line7) == SET)
-    {
-        if (GPIO_ReadInputDataBit(GPIOB, GPIO_Pin_7) == 0)
+        if (!Key_State[i])
         {
-            while (GPIO_ReadInputDataBit(GPIOB, GPIO_Pin_7) == 0)
-                ;
-            KeyNum = 6;
+            if (Key_Filter[i] == KEY_FILTER)
+            {
+                Key_State[i] = 1;
+                Key_Hold[i] = 0;
+                Key_Put(KEY_PRESS | Key_Code[i]);
+            }
         }
-        EXTI_ClearITPendingBit(EXTI_Line7);
-    }
-}
-
-void EXTI15_10_IRQHandler(void)
-{
-    // PB10 上方向键,键码:8
-    if (EXTI_GetITStatus(EXTI_Line10) == SET)
-    {
-        if (GPIO_ReadInputDataBit(GPIOB, GPIO_Pin_10) == 0)
+        else if (Key_Filter[i] == 0)
         {
-            while (GPIO_ReadInputDataBit(GPIOB, GPIO_Pin_10) == 0)
-                ;
-            KeyNum = 8;
+            Key_State[i] = 0;
+            Key_Put(KEY_RELEASE | Key_Code[i]);
         }
-        EXTI_ClearITPendingBit(EXTI_Line10);
-    }
-
-    // PB11 下方向键,键码:2
-    if (EXTI_GetITStatus(EXTI_Line11) == SET)
-    {
-        if (GPIO_ReadInputDataBit(GPIOB, GPIO_Pin_11) == 0)
+        else if (Key_Hold[i] < KEY_LONG_TIME + KEY_REPEAT_TIME)
         {
-            while (GPIO_ReadInputDataBit(GPIOB, GPIO_Pin_11) == 0)
-                ;
-            KeyNum = 2;
+            Key_Hold[i]++;
+            if (Key_Hold[i] == KEY_LONG_TIME)
+                Key_Put(KEY_LONG | Key_Code[i]);
+            else if (Key_Hold[i] == KEY_LONG_TIME + KEY_REPEAT_TIME)
+            {
+                Key_Put(KEY_REPEAT | Key_Code[i]);
+                Key_Hold[i] = KEY_LONG_TIME;
+            }
         }
-        EXTI_ClearITPendingBit(EXTI_Line11);
     }
+}
 
-    // PB12 返回键,键码:1
-    if (EXTI_GetITStatus(EXTI_Line12) == SET)
+void TIM3_IRQHandler(void)
+{
+    if (TIM_GetITStatus(TIM3, TIM_IT_Update) == SET)
     {
-        if (GPIO_ReadInputDataBit(GPIOB, GPIO_Pin_12) == 0)
-        {
-            while (GPIO_ReadInputDataBit(GPIOB, GPIO_Pin_12) == 0)
-                ;
-            KeyNum = 1;
-        }
-        EXTI_ClearITPendingBit(EXTI_Line12);
+        Key_Scan();
+        TIM_ClearITPendingBit(TIM3, TIM_IT_Update);
     }
 }
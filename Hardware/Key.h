@@ -1,9 +1,18 @@
 #ifndef __KEY_H
 #define __KEY_H
 
-extern uint8_t KeyNum;
+// 按键事件类型, 位于事件高4位
+#define KEY_PRESS 0x10   // 按下
+#define KEY_RELEASE 0x20 // 松开
+#define KEY_LONG 0x30    // 长按(按住1秒)
+#define KEY_REPEAT 0x40  // 长按后连发(每100ms一次)
+
+#define KEY_TYPE(Event) ((Event) & 0xF0) // 取事件类型
+#define KEY_CODE(Event) ((Event) & 0x0F) // 取键码
+
+extern uint32_t Key_Lost;
 
 void Key_Init(void);
-uint8_t GetKeyNum(void);
+uint8_t Key_GetEvent(void);
 
 #endif
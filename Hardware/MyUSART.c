@@ -1,10 +1,39 @@
 #include "stm32f10x.h" // Device header
 #include "MyUSART.h"
-#include "esp.h"
 #include <string.h>
 
-char RECS[250];
-unsigned char i;
+#define MYUSART_RX_SIZE 512 // DMA循环接收缓冲区大小
+#define MYUSART_TX_SIZE 512 // 发送环形缓冲区大小
+#define MYUSART_CB_LEN 4    // 发送完成回调队列长度
+
+/*
+ * 接收缓冲区为单生产者单消费者无锁队列:
+ * 生产者为DMA1通道5与中断(只写MyUSART_RxIn), 消费者为主循环(只写MyUSART_RxOut).
+ * 两者均为累计字节数, 差值即未读字节数, 无需关中断.
+ */
+static uint8_t MyUSART_RxBuf[MYUSART_RX_SIZE];
+static volatile uint32_t MyUSART_RxIn = 0; // DMA已写入字节累计数
+static uint32_t MyUSART_RxOut = 0;         // 主循环已取出字节累计数
+static uint16_t MyUSART_RxPos = 0;         // 上次中断时DMA写入位置
+
+uint32_t MyUSART_RxLost = 0; // 因缓冲区溢出或行过长丢弃的字节数
+
+char RECS[256];              // 行缓冲, 由MyUSART_GetLine在主循环中组装
+static uint16_t RECS_Len = 0; // 行缓冲已有字节数
+static uint8_t RECS_Skip = 0; // 溢出后丢弃至下一个换行符标志, 该行开头已被覆盖
+
+/*
+ * 发送缓冲区同为单生产者单消费者队列:
+ * 生产者为主循环(只写MyUSART_TxIn), 消费者为DMA1通道4传输完成中断(只写MyUSART_TxOut).
+ */
+static uint8_t MyUSART_TxBuf[MYUSART_TX_SIZE];
+static volatile uint32_t MyUSART_TxIn = 0;    // 已写入字节累计数
+static volatile uint32_t MyUSART_TxOut = 0;   // 已发送字节累计数
+static volatile uint16_t MyUSART_TxDMALen = 0; // 当前DMA传输字节数, 0表示DMA空闲
+
+static uint32_t MyUSART_CbEnd[MYUSART_CB_LEN];          // 回调触发时的已发送字节累计数
+static MyUSART_Callback MyUSART_CbFunc[MYUSART_CB_LEN]; // 发送完成回调
+static volatile uint8_t MyUSART_CbIn = 0, MyUSART_CbOut = 0;
 
 void MyUSART_Init(void)
 {
@@ -33,6 +62,31 @@ void MyUSART_Init(void)
     USART_InitStructure.USART_WordLength = USART_WordLength_8b;
     USART_Init(USART1, &USART_InitStructure);
 
+    RCC_AHBPeriphClockCmd(RCC_AHBPeriph_DMA1, ENABLE); // DMA1通道5: USART1_RX, 循环模式
+    DMA_InitTypeDef DMA_InitStructure;
+    DMA_InitStructure.DMA_PeripheralBaseAddr = (uint32_t)&USART1->DR;
+    DMA_InitStructure.DMA_MemoryBaseAddr = (uint32_t)MyUSART_RxBuf;
+    DMA_InitStructure.DMA_DIR = DMA_DIR_PeripheralSRC;
+    DMA_InitStructure.DMA_BufferSize = MYUSART_RX_SIZE;
+    DMA_InitStructure.DMA_PeripheralInc = DMA_PeripheralInc_Disable;
+    DMA_InitStructure.DMA_MemoryInc = DMA_MemoryInc_Enable;
+    DMA_InitStructure.DMA_PeripheralDataSize = DMA_PeripheralDataSize_Byte;
+    DMA_InitStructure.DMA_MemoryDataSize = DMA_MemoryDataSize_Byte;
+    DMA_InitStructure.DMA_Mode = DMA_Mode_Circular;
+    DMA_InitStructure.DMA_Priority = DMA_Priority_High;
+    DMA_InitStructure.DMA_M2M = DMA_M2M_Disable;
+    DMA_Init(DMA1_Channel5, &DMA_InitStructure);
+    DMA_ITConfig(DMA1_Channel5, DMA_IT_HT | DMA_IT_TC, ENABLE); // 半满/全满中断保证每半圈至少更新一次写入位置
+    DMA_Cmd(DMA1_Channel5, ENABLE);
+
+    DMA_InitStructure.DMA_MemoryBaseAddr = (uint32_t)MyUSART_TxBuf; // DMA1通道4: USART1_TX, 单次模式
+    DMA_InitStructure.DMA_DIR = DMA_DIR_PeripheralDST;
+    DMA_InitStructure.DMA_BufferSize = 0;
+    DMA_InitStructure.DMA_Mode = DMA_Mode_Normal;
+    DMA_InitStructure.DMA_Priority = DMA_Priority_Medium;
+    DMA_Init(DMA1_Channel4, &DMA_InitStructure);
+    DMA_ITConfig(DMA1_Channel4, DMA_IT_TC, ENABLE);
+
     NVIC_InitTypeDef NVIC_InitStructure;
     NVIC_InitStructure.NVIC_IRQChannel = USART1_IRQn;
     NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
@@ -40,7 +94,15 @@ void MyUSART_Init(void)
     NVIC_InitStructure.NVIC_IRQChannelSubPriority = 0;
     NVIC_Init(&NVIC_InitStructure);
 
-    USART_ITConfig(USART1, USART_IT_RXNE, ENABLE);
+    NVIC_InitStructure.NVIC_IRQChannel = DMA1_Channel5_IRQn; // 与USART1中断同优先级, 互不嵌套
+    NVIC_Init(&NVIC_InitStructure);
+
+    NVIC_InitStructure.NVIC_IRQChannel = DMA1_Channel4_IRQn;
+    NVIC_InitStructure.NVIC_IRQChannelSubPriority = 1;
+    NVIC_Init(&NVIC_InitStructure);
+
+    USART_DMACmd(USART1, USART_DMAReq_Rx | USART_DMAReq_Tx, ENABLE);
+    USART_ITConfig(USART1, USART_IT_IDLE, ENABLE); // 空闲线检测, 一帧数据接收完毕即通知
     USART_Cmd(USART1, ENABLE);
 }
 
@@ -49,23 +111,193 @@ char *MyUSART_GetString(void)
     return RECS;
 }
 
+/**
+ * @brief  DMA空闲且有待发送数据时, 启动一次DMA传输(至多到缓冲区末尾)
+ *         须在关中断状态或DMA1通道4中断内调用
+ * @param  无
+ * @retval 无
+ */
+static void MyUSART_TxKick(void)
+{
+    uint16_t Len;
+    uint16_t Pos = MyUSART_TxOut % MYUSART_TX_SIZE;
+
+    if (MyUSART_TxDMALen || (MyUSART_TxIn == MyUSART_TxOut))
+        return;
+
+    Len = MyUSART_TxIn - MyUSART_TxOut;
+    if (Len > MYUSART_TX_SIZE - Pos)
+        Len = MYUSART_TX_SIZE - Pos;
+
+    MyUSART_TxDMALen = Len;
+    DMA_Cmd(DMA1_Channel4, DISABLE);
+    DMA1_Channel4->CMAR = (uint32_t)&MyUSART_TxBuf[Pos];
+    DMA_SetCurrDataCounter(DMA1_Channel4, Len);
+    DMA_Cmd(DMA1_Channel4, ENABLE);
+}
+
+/**
+ * @brief  将数据写入发送缓冲区并由DMA在后台发出, 缓冲区有空间时立即返回
+ * @param  Data 数据
+ * @param  Len 字节数
+ * @param  Done 数据全部交给串口后的回调(在DMA中断内调用, 应尽量简短), 可为NULL
+ * @retval 0:已写入 | 1:回调队列已满, 未写入任何数据
+ */
+uint8_t MyUSART_Write(const uint8_t *Data, uint16_t Len, MyUSART_Callback Done)
+{
+    if (Done)
+    {
+        if ((uint8_t)(MyUSART_CbIn - MyUSART_CbOut) >= MYUSART_CB_LEN) // 回调队列满
+            return 1;
+        // 先登记回调再写入数据: 登记时TxOut尚不可能到达CbEnd, 正在进行的DMA传输完成时
+        // 中断若接着发出本次数据, 回调也已在队列中
+        MyUSART_CbEnd[MyUSART_CbIn % MYUSART_CB_LEN] = MyUSART_TxIn + Len;
+        MyUSART_CbFunc[MyUSART_CbIn % MYUSART_CB_LEN] = Done;
+        MyUSART_CbIn++;
+    }
+
+    while (Len)
+    {
+        while (MyUSART_TxIn - MyUSART_TxOut >= MYUSART_TX_SIZE) // 缓冲区满, 等待DMA腾出空间
+        {
+            __disable_irq();
+            MyUSART_TxKick();
+            __enable_irq();
+        }
+        MyUSART_TxBuf[MyUSART_TxIn % MYUSART_TX_SIZE] = *Data++;
+        MyUSART_TxIn++;
+        Len--;
+    }
+
+    __disable_irq();
+    MyUSART_TxKick();
+    __enable_irq();
+    return 0;
+}
+
+/**
+ * @brief  查询发送缓冲区是否已全部发出
+ * @param  无
+ * @retval 1:仍有数据待发送 | 0:已全部发出
+ */
+uint8_t MyUSART_TxBusy(void)
+{
+    return MyUSART_TxIn != MyUSART_TxOut;
+}
+
 void MyUSART_SendString(char *str)
 {
-    uint8_t stri = 0;
-    while (str[stri] != '\0')
-        USART_SendData(USART1, str[stri++]);
+    MyUSART_Write((const uint8_t *)str, strlen(str), NULL);
 }
 
-void USART1_IRQHandler()
+/**
+ * @brief  将字符写入发送缓冲区, 可作为Fmt_Init的Flush, 使格式化结果经小缓冲区分段直接进入发送队列:
+ *         char Buf[32]; Fmt_Init(&F, Buf, sizeof(Buf), MyUSART_Put); ... Fmt_End(&F);
+ * @param  Data 字符
+ * @param  Len 字符数
+ * @retval 无
+ */
+void MyUSART_Put(const char *Data, uint16_t Len)
 {
-    if (USART_GetITStatus(USART1, USART_IT_RXNE))
+    MyUSART_Write((const uint8_t *)Data, Len, NULL);
+}
+
+/**
+ * @brief  根据DMA剩余计数更新已写入字节累计数, 由中断调用, 执行时间固定
+ * @param  无
+ * @retval 无
+ */
+static void MyUSART_RxUpdate(void)
+{
+    uint16_t Pos = MYUSART_RX_SIZE - DMA_GetCurrDataCounter(DMA1_Channel5);
+    if (Pos == MYUSART_RX_SIZE)
+        Pos = 0;
+    MyUSART_RxIn += (uint16_t)(Pos + MYUSART_RX_SIZE - MyUSART_RxPos) % MYUSART_RX_SIZE;
+    MyUSART_RxPos = Pos;
+}
+
+/**
+ * @brief  从接收缓冲区取出一行数据, 在主循环中调用, 不阻塞
+ * @param  无
+ * @retval 完整的一行(不含"\r\n", 有效至下次调用), 暂无完整行时返回NULL
+ */
+char *MyUSART_GetLine(void)
+{
+    uint32_t In = MyUSART_RxIn;
+    char Ch;
+
+    // 未读数据已达缓冲区大小: DMA已(或即将)覆盖未读数据, 写满一整圈时写入位置不变, 无法区分
+    // 丢弃未读数据与正在组装的行, 并丢弃至下一个换行符, 不把残缺的行交给调用者
+    if (In - MyUSART_RxOut >= MYUSART_RX_SIZE)
+    {
+        MyUSART_RxLost += In - MyUSART_RxOut + RECS_Len;
+        MyUSART_RxOut = In;
+        RECS_Len = 0;
+        RECS_Skip = 1;
+        return NULL;
+    }
+
+    while (MyUSART_RxOut != In)
     {
-        RECS[i++] = USART_ReceiveData(USART1);
-        if ((RECS[i - 2] == '\r') | (RECS[i - 1] == '\n'))
+        Ch = MyUSART_RxBuf[MyUSART_RxOut % MYUSART_RX_SIZE];
+        MyUSART_RxOut++;
+        if (RECS_Skip)
+        {
+            MyUSART_RxLost++;
+            if (Ch == '\n')
+                RECS_Skip = 0;
+            continue;
+        }
+        if (Ch == '\n')
         {
-            RECS[i - 2] = '\0';
-            i = 0;
-            CommandAnalyse();
+            if ((RECS_Len > 0) && (RECS[RECS_Len - 1] == '\r'))
+                RECS_Len--;
+            RECS[RECS_Len] = '\0';
+            RECS_Len = 0;
+            return RECS;
         }
+        if (RECS_Len < sizeof(RECS) - 1)
+            RECS[RECS_Len++] = Ch;
+        else
+            MyUSART_RxLost++; // 行过长, 超出部分丢弃
+    }
+    return NULL;
+}
+
+void USART1_IRQHandler(void)
+{
+    if (USART_GetITStatus(USART1, USART_IT_IDLE) != RESET)
+    {
+        USART_ReceiveData(USART1); // 先读SR再读DR, 清除IDLE标志
+        MyUSART_RxUpdate();
+    }
+}
+
+void DMA1_Channel4_IRQHandler(void)
+{
+    if (DMA_GetITStatus(DMA1_IT_TC4) != RESET)
+    {
+        DMA_ClearITPendingBit(DMA1_IT_TC4);
+        MyUSART_TxOut += MyUSART_TxDMALen;
+        MyUSART_TxDMALen = 0;
+
+        while ((MyUSART_CbOut != MyUSART_CbIn) &&
+               ((int32_t)(MyUSART_TxOut - MyUSART_CbEnd[MyUSART_CbOut % MYUSART_CB_LEN]) >= 0))
+        {
+            MyUSART_CbFunc[MyUSART_CbOut % MYUSART_CB_LEN]();
+            MyUSART_CbOut++;
+        }
+
+        MyUSART_TxKick();
+    }
+}
+
+void DMA1_Channel5_IRQHandler(void)
+{
+    // DMA_GetITStatus每次只能查询一个标志(IS_DMA_GET_IT), 清除可以合并
+    if ((DMA_GetITStatus(DMA1_IT_HT5) != RESET) || (DMA_GetITStatus(DMA1_IT_TC5) != RESET))
+    {
+        DMA_ClearITPendingBit(DMA1_IT_HT5 | DMA1_IT_TC5);
+        MyUSART_RxUpdate();
     }
 }
@@ -1,8 +1,16 @@
 #ifndef __MyUSART_H
 #define __MyUSART_H
 
+extern uint32_t MyUSART_RxLost;
+
+typedef void (*MyUSART_Callback)(void);
+
 void MyUSART_Init(void);
 char *MyUSART_GetString(void);
+char *MyUSART_GetLine(void);
 void MyUSART_SendString(char *str);
+uint8_t MyUSART_Write(const uint8_t *Data, uint16_t Len, MyUSART_Callback Done);
+uint8_t MyUSART_TxBusy(void);
+void MyUSART_Put(const char *Data, uint16_t Len);
 
 #endif
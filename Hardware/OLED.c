@@ -12,232 +12,272 @@
 #include "OLED.h"
 #include "OLED_Font.h"
 
-#define I2C_ACK 0
-#define I2C_NO_ACK 1
-#define OLED_R_SDA() GPIO_ReadInputDataBit(GPIOX, SDA_Pin)
-#define OLED_W_SCL(x) GPIO_WriteBit(GPIOX, SCL_Pin, (BitAction)(x))
-#define OLED_W_SDA(x) GPIO_WriteBit(GPIOX, SDA_Pin, (BitAction)(x))
+static uint8_t OLED_GRAM[8][128]; // 显存缓冲, [页][列]
+static uint8_t OLED_DirtyS[8];    // 各页待刷新区间起始列
+static uint8_t OLED_DirtyE[8];    // 各页待刷新区间终止列(不含), 与起始列相等表示该页无改动
+
+#if OLED_TRANSPORT == OLED_TRANSPORT_I2C1
+static uint8_t OLED_SendS[8];    // 本次后台刷新中各页待发送区间起始列
+static uint8_t OLED_SendE[8];    // 各页待发送区间终止列(不含), 与起始列相等表示该页无需发送
+static uint8_t OLED_SendPage = 8; // 后台刷新下一个检查的页, 8表示没有进行中的刷新
+static uint8_t OLED_CurPage;      // 正在发送的页及其区间, 传输失败时恢复
+static uint8_t OLED_CurS;
+static uint8_t OLED_CurE;
+#endif
 
 /**
- * @brief  模拟I2C信号IO口初始化。
- * @param  无
+ * @brief  向OLED屏发送命令。
+ * @param  Command 要写入的命令。
  * @retval 无
  */
-void Sim_I2C_Init(void)
+void OLED_WriteCommand(uint8_t Command)
 {
-    RCC_APB2PeriphClockCmd(APB2_GPIO, ENABLE);
-
-    GPIO_InitTypeDef GPIO_InitStructure;
-    GPIO_InitStructure.GPIO_Mode = GPIO_Mode_Out_OD;
-    GPIO_InitStructure.GPIO_Speed = GPIO_Speed_50MHz;
-
-    GPIO_InitStructure.GPIO_Pin = SCL_Pin;
-    GPIO_Init(GPIOX, &GPIO_InitStructure);
-
-    GPIO_InitStructure.GPIO_Pin = SDA_Pin;
-    GPIO_Init(GPIOX, &GPIO_InitStructure);
-
-    OLED_W_SCL(1);
-    OLED_W_SDA(1);
+    OLED_WriteCommands(&Command, 1);
 }
 
 /**
- * @brief  模拟I2C起始信号。
- * @param  无
+ * @brief  向OLED屏发送数据。
+ * @param  Data 要写入的数据。
  * @retval 无
  */
-void Sim_I2C_Start(void)
+void OLED_WriteData(uint8_t Data)
 {
-    OLED_W_SDA(1);
-    OLED_W_SCL(1);
-    OLED_W_SDA(0);
-    OLED_W_SCL(0);
+    OLED_WriteDataStream(&Data, 1);
 }
 
 /**
- * @brief  模拟I2C停止信号。
- * @param  无
+ * @brief  设置屏幕显示起始坐标。
+ * @param  Line 行（页）地址，以左上角为原点，向下方向的坐标。
+ *     @arg 取值: 0 - 7
+ * @param  Column 列地址，以左上角为原点，向右方向的坐标。
+ *     @arg 取值: 0 - 127
  * @retval 无
  */
-void Sim_I2C_Stop(void)
+void OLED_SetCursor(uint8_t Line, uint8_t Column)
 {
-    OLED_W_SDA(0);
-    OLED_W_SCL(1);
-    OLED_W_SDA(1);
+#if OLED_TRANSPORT == OLED_TRANSPORT_I2C1
+    // 水平寻址模式下以列、页地址窗口定位光标, 窗口右下角固定为屏幕右下角
+    uint8_t Command[6] = {0x21, 0, 127, 0x22, 0, 7};
+    Command[1] = Column; // 起始列地址
+    Command[4] = Line;   // 起始页地址
+    OLED_WriteCommands(Command, 6);
+#else
+    uint8_t Command[3];
+    Command[0] = 0xB0 | Line;                   // 设置行地址位置
+    Command[1] = 0x10 | ((Column & 0xF0) >> 4); // 设置列地址位置高4位
+    Command[2] = 0x00 | (Column & 0x0F);        // 设置列地址位置低4位
+    OLED_WriteCommands(Command, 3);
+#endif
 }
 
 /**
- * @brief  模拟I2C读取从机应答信号。
- * @param  无
- * @retval 从机应答状态，I2C_NO_ACK: 无应答，I2C_ACK: 应答。
+ * @brief  从指定坐标开始连续写入一段数据(一页内的字形或整页内容)。
+ *         光标设置与数据各占一次I2C传输。
+ * @param  Line 行（页）地址。
+ *     @arg 取值: 0 - 7
+ * @param  Column 起始列地址。
+ *     @arg 取值: 0 - 127
+ * @param  Data 数据数组。
+ * @param  Len 数据字节数, 不应超过该页剩余列数。
+ * @retval 无
  */
-uint8_t I2C_Wait_Ack(void)
+void OLED_WritePage(uint8_t Line, uint8_t Column, const uint8_t *Data, uint8_t Len)
 {
-    uint8_t ack;
-    OLED_W_SCL(0);
-    OLED_W_SDA(1);
-    OLED_W_SCL(1);
-
-    if (OLED_R_SDA())
-        ack = I2C_NO_ACK;
-    else
-        ack = I2C_ACK;
-
-    OLED_W_SCL(0);
-    return ack;
+    OLED_SetCursor(Line, Column);
+    OLED_WriteDataStream(Data, Len);
 }
 
 /**
- * @brief  模拟I2C主机发送应答信号。
- * @param  ack 决定主机是否发送应答信号。
- *     @arg I2C_ACK: 发送应答信号
- *     @arg I2C_NO_ACK: 不发送应答信号
+ * @brief  OLED熄屏。
+ * @param  无
  * @retval 无
  */
-void I2C_Send_Ack(uint8_t ack)
+void OLED_Display_Off(void)
 {
-    OLED_W_SCL(0);
-
-    if (ack == I2C_ACK)
-        OLED_W_SDA(0);
-    else
-        OLED_W_SDA(1);
-
-    OLED_W_SCL(1);
-    OLED_W_SCL(0);
+    OLED_WriteCommand(0XAE); // 熄屏
+    OLED_WriteCommand(0X8D); // 设置OLED电荷泵
+    OLED_WriteCommand(0X10); // 失能，关
 }
 
 /**
- * @brief  I2C读取一个字节。
- * @param  ack 决定主机是否发送应答信号。
- *     @arg I2C_ACK: 发送应答信号
- *     @arg I2C_NO_ACK: 不发送应答信号
- * @retval data 读取到的数据
+ * @brief  OLED亮屏。
+ * @param  无
+ * @retval 无
  */
-uint8_t I2C_Read_Byte(uint8_t ack)
+void OLED_Display_On(void)
 {
-    uint8_t data = 0;
-    uint8_t i;
-    OLED_W_SCL(0);
-    OLED_W_SDA(1);
-    for (i = 0; i < 8; i++)
-    {
-        OLED_W_SCL(1);
-        data <<= 1;
-
-        if (OLED_R_SDA())
-            data |= 0x01;
-        else
-            data &= 0xFE;
-
-        OLED_W_SCL(0);
-    }
-    I2C_Send_Ack(ack);
-    return data;
+    OLED_WriteCommand(0X8D); // 设置OLED电荷泵
+    OLED_WriteCommand(0X14); // 使能，开
+    OLED_WriteCommand(0XAF); // 亮屏
 }
 
 /**
- * @brief  I2C发送一个字节。
- * @param  Byte  要发送的一个字节。
+ * @brief  向显存写入一个字节, 内容有变化时扩展该页的待刷新区间。
+ * @param  Page 页地址。
+ *     @arg 取值: 0 - 7
+ * @param  Column 列地址。
+ *     @arg 取值: 0 - 127, 超出范围的写入被忽略
+ * @param  Data 要写入的数据。
  * @retval 无
  */
-void I2C_Send_Byte(uint8_t Byte)
+static void OLED_GRAM_Write(uint8_t Page, uint8_t Column, uint8_t Data)
 {
-    uint8_t i;
-    for (i = 0; i < 8; i++)
+    if ((Page > 7) || (Column > 127))
+        return;
+
+    if (OLED_GRAM[Page][Column] != Data)
     {
-        OLED_W_SDA(Byte & (0x80 >> i));
-        OLED_W_SCL(1);
-        OLED_W_SCL(0);
+        OLED_GRAM[Page][Column] = Data;
+        if (OLED_DirtyS[Page] == OLED_DirtyE[Page]) // 该页原本无改动
+        {
+            OLED_DirtyS[Page] = Column;
+            OLED_DirtyE[Page] = Column + 1;
+        }
+        else if (Column < OLED_DirtyS[Page])
+            OLED_DirtyS[Page] = Column;
+        else if (Column >= OLED_DirtyE[Page])
+            OLED_DirtyE[Page] = Column + 1;
     }
-
-    // while(I2C_Wait_Ack());    //等待从机应答信号
-
-    OLED_W_SCL(1); // 变化时钟信号，不等待从机应答
-    OLED_W_SCL(0);
 }
 
 /**
- * @brief  向OLED屏发送命令。
- * @param  Command 要写入的命令。
+ * @brief  将显存中有改动的列区间刷新到屏幕, 每页只发送自上次刷新以来内容变化的列区间。
+ *         软件I2C: 函数返回时刷新已完成。
+ *         硬件I2C1: 每个有改动的页各用一次DMA传输(光标命令与数据在同一次传输内),
+ *         在后台逐页完成, 函数立即返回; 上一次刷新未完成时本次调用直接返回, 改动保留到下一次调用。
+ *         画面不变时不产生总线传输。
+ * @param  无
  * @retval 无
  */
-void OLED_WriteCommand(uint8_t Command)
+void OLED_Refresh(void)
 {
-    Sim_I2C_Start();
-    I2C_Send_Byte(0x78); // 从机地址
-    I2C_Send_Byte(0x00); // 写命令
-    I2C_Send_Byte(Command);
-    Sim_I2C_Stop();
-}
+    uint8_t Page;
+#if OLED_TRANSPORT == OLED_TRANSPORT_I2C1
+    if (OLED_Busy())
+        return;
 
-/**
- * @brief  向OLED屏发送数据。
- * @param  Data 要写入的数据。
- * @retval 无
- */
-void OLED_WriteData(uint8_t Data)
-{
-    Sim_I2C_Start();
-    I2C_Send_Byte(0x78); // 从机地址
-    I2C_Send_Byte(0x40); // 写数据
-    I2C_Send_Byte(Data);
-    Sim_I2C_Stop();
+    // 本次改动并入待发送区间(上次因总线异常未发出的区间仍保留在内)
+    for (Page = 0; Page < 8; Page++)
+    {
+        if (OLED_DirtyS[Page] == OLED_DirtyE[Page])
+            continue;
+        if (OLED_SendS[Page] == OLED_SendE[Page])
+        {
+            OLED_SendS[Page] = OLED_DirtyS[Page];
+            OLED_SendE[Page] = OLED_DirtyE[Page];
+        }
+        else
+        {
+            if (OLED_DirtyS[Page] < OLED_SendS[Page])
+                OLED_SendS[Page] = OLED_DirtyS[Page];
+            if (OLED_DirtyE[Page] > OLED_SendE[Page])
+                OLED_SendE[Page] = OLED_DirtyE[Page];
+        }
+        OLED_DirtyS[Page] = OLED_DirtyE[Page] = 0;
+    }
+    OLED_SendPage = 0;
+    OLED_RefreshNext(0);
+#else
+    for (Page = 0; Page < 8; Page++)
+    {
+        if (OLED_DirtyS[Page] == OLED_DirtyE[Page])
+            continue;
+
+        OLED_WritePage(Page, OLED_DirtyS[Page], &OLED_GRAM[Page][OLED_DirtyS[Page]],
+                       OLED_DirtyE[Page] - OLED_DirtyS[Page]);
+        OLED_DirtyS[Page] = OLED_DirtyE[Page] = 0;
+    }
+#endif
 }
 
+#if OLED_TRANSPORT == OLED_TRANSPORT_I2C1
 /**
- * @brief  设置屏幕显示起始坐标。
- * @param  Line 行（页）地址，以左上角为原点，向下方向的坐标。
- *     @arg 取值: 0 - 7
- * @param  Column 列地址，以左上角为原点，向右方向的坐标。
- *     @arg 取值: 0 - 127
+ * @brief  结束当前页的传输并启动下一个待发送页。由OLED_Refresh启动首页, 其后在I2C1事件中断中
+ *         (上一页停止信号发出后)调用, 直到各页发送完毕。总线异常时停止本次刷新, 当前页及未发出的区间
+ *         留待下一次OLED_Refresh
+ * @param  Failed 1:当前页传输失败 | 0:当前页已发送(或尚无当前页)
  * @retval 无
  */
-void OLED_SetCursor(uint8_t Line, uint8_t Column)
+void OLED_RefreshNext(uint8_t Failed)
 {
-    OLED_WriteCommand(0xB0 | Line);                   // 设置行地址位置
-    OLED_WriteCommand(0x10 | ((Column & 0xF0) >> 4)); // 设置列地址位置高4位
-    OLED_WriteCommand(0x00 | (Column & 0x0F));        // 设置列地址位置低4位
+    uint8_t Page, S, E;
+
+    if (Failed)
+    {
+        OLED_SendS[OLED_CurPage] = OLED_CurS;
+        OLED_SendE[OLED_CurPage] = OLED_CurE;
+        OLED_SendPage = 8;
+        return;
+    }
+    while (OLED_SendPage < 8)
+    {
+        Page = OLED_SendPage++;
+        S = OLED_SendS[Page];
+        E = OLED_SendE[Page];
+        if (S == E)
+            continue;
+
+        OLED_CurPage = Page;
+        OLED_CurS = S;
+        OLED_CurE = E;
+        OLED_SendS[Page] = OLED_SendE[Page] = 0;
+        if (OLED_WriteWindowDMA(Page, S, &OLED_GRAM[Page][S], E - S))
+            OLED_RefreshNext(1);
+        return;
+    }
 }
+#endif
 
 /**
- * @brief  OLED熄屏。
+ * @brief  刷新屏幕并等待刷新完成。
+ *         用于随后要长时间阻塞的场合(启动画面、投饵动作), 保证改动已全部显示。
  * @param  无
  * @retval 无
  */
-void OLED_Display_Off(void)
+void OLED_RefreshSync(void)
 {
-    OLED_WriteCommand(0XAE); // 熄屏
-    OLED_WriteCommand(0X8D); // 设置OLED电荷泵
-    OLED_WriteCommand(0X10); // 失能，关
+    while (OLED_Busy())
+        ;
+    OLED_Refresh();
+    while (OLED_Busy())
+        ;
 }
 
 /**
- * @brief  OLED亮屏。
+ * @brief  OLED清屏(清空显存, 调用OLED_Refresh后生效)。
  * @param  无
  * @retval 无
  */
-void OLED_Display_On(void)
+void OLED_Clear(void)
 {
-    OLED_WriteCommand(0X8D); // 设置OLED电荷泵
-    OLED_WriteCommand(0X14); // 使能，开
-    OLED_WriteCommand(0XAF); // 亮屏
+    uint8_t i, j;
+    for (j = 0; j < 8; j++)
+    {
+        for (i = 0; i < 128; i++)
+        {
+            OLED_GRAM_Write(j, i, 0x00);
+        }
+    }
 }
 
 /**
- * @brief  OLED清屏。
- * @param  无
+ * @brief  OLED清除一块区域(清空显存, 调用OLED_Refresh后生效)。
+ * @param  Line 起始行位置。
+ *     @arg 取值: 1 - 8
+ * @param  Column 起始列位置。
+ *     @arg 取值: 1 - 128
+ * @param  Height 行数(每行8像素)。
+ * @param  Width 列数。
  * @retval 无
  */
-void OLED_Clear(void)
+void OLED_ClearArea(uint8_t Line, uint8_t Column, uint8_t Height, uint8_t Width)
 {
     uint8_t i, j;
-    for (j = 0; j < 8; j++)
+    for (j = 0; j < Height; j++)
     {
-        OLED_SetCursor(j, 0);
-        for (i = 0; i < 128; i++)
+        for (i = 0; i < Width; i++)
         {
-            OLED_WriteData(0x00);
+            OLED_GRAM_Write(Line - 1 + j, Column - 1 + i, 0x00);
         }
     }
 }
@@ -278,22 +318,6 @@ void OLED_Stop_Scroll(void)
     OLED_WriteCommand(0x2E); // 关闭滚动
 }
 
-/**
- * @brief  计算x^y。
- * @param  X 无符号整形数。
- * @param  Y 无符号整形数。
- * @retval Result X的Y次方
- */
-uint32_t OLED_Pow(uint32_t X, uint32_t Y)
-{
-    uint32_t Result = 1;
-    while (Y--)
-    {
-        Result *= X;
-    }
-    return Result;
-}
-
 /**
  * @brief  OLED初始化
  * @param  无
@@ -309,7 +333,7 @@ void OLED_Init(void)
             ;
     }
 
-    Sim_I2C_Init(); // 端口初始化
+    OLED_Bus_Init(); // 总线初始化
 
     OLED_WriteCommand(0xAE); // 关闭显示
 
@@ -347,9 +371,21 @@ void OLED_Init(void)
     OLED_WriteCommand(0x8D); // 设置充电泵
     OLED_WriteCommand(0x14);
 
+#if OLED_TRANSPORT == OLED_TRANSPORT_I2C1
+    OLED_WriteCommand(0x20); // 设置内存寻址模式
+    OLED_WriteCommand(0x00); // 水平寻址, 整帧可由一次传输连续写入
+#endif
+
     OLED_WriteCommand(0xAF); // 开启显示
 
-    OLED_Clear(); // OLED清屏
+    // 屏幕上电后GDDRAM内容随机, 整屏标记为待刷新, 以全0显存覆盖
+    for (i = 0; i < 8; i++)
+    {
+        OLED_DirtyS[i] = 0;
+        OLED_DirtyE[i] = 128;
+    }
+    OLED_Clear();
+    OLED_RefreshSync();
 }
 
 /**
@@ -369,23 +405,17 @@ void OLED_ShowChar(uint8_t Line, uint8_t Column, int8_t Char, uint8_t Size)
     uint8_t i;
     if (Size == 8) // 字符大小8x16
     {
-        OLED_SetCursor(Line - 1, Column - 1); // 设置光标位置在上半部分
-        for (i = 0; i < 8; i++)
-        {
-            OLED_WriteData(OLED_F8x16[Char - ' '][i]); // 显示上半部分内容
-        }
-        OLED_SetCursor((Line - 1) + 1, Column - 1); // 设置光标位置在下半部分
         for (i = 0; i < 8; i++)
         {
-            OLED_WriteData(OLED_F8x16[Char - ' '][i + 8]); // 显示下半部分内容
+            OLED_GRAM_Write(Line - 1, Column - 1 + i, OLED_F8x16[Char - ' '][i]);           // 上半部分内容
+            OLED_GRAM_Write((Line - 1) + 1, Column - 1 + i, OLED_F8x16[Char - ' '][i + 8]); // 下半部分内容
         }
     }
     else // 字符大小6x8
     {
-        OLED_SetCursor(Line - 1, Column - 1);
         for (i = 0; i < 6; i++)
         {
-            OLED_WriteData(OLED_F6x8[Char - ' '][i]);
+            OLED_GRAM_Write(Line - 1, Column - 1 + i, OLED_F6x8[Char - ' '][i]);
         }
     }
 }
@@ -427,55 +457,50 @@ void OLED_ShowString(uint8_t Line, uint8_t Column, char *String, uint8_t Size)
  */
 void OLED_ShowNum(uint8_t Line, uint8_t Column, uint32_t Number, uint8_t Length, uint8_t Size)
 {
-    uint8_t i;
-    for (i = 0; i < Length; i++)
+    uint8_t i = Length;
+    while (i--) // 由低位向高位, 每位一次除法
     {
-        OLED_ShowChar(Line, Column + Size * i, Number / OLED_Pow(10, Length - i - 1) % 10 + '0', Size);
+        OLED_ShowChar(Line, Column + Size * i, Number % 10 + '0', Size);
+        Number /= 10;
     }
 }
 
 /**
- * @brief  OLED显示有符号浮点数
+ * @brief  OLED显示有符号定点小数
  * @param  Line 起始行位置。
  *     @arg 取值: 1 - 8
  * @param  Column 起始列位置。
  *     @arg 取值: 1 - 128
- * @param  Num 要显示的数字。
- *     @arg 取值: -3.4028235E38 - +3.4028235E38
+ * @param  Num 要显示的数字乘以10的Declen次方, 如Declen为2时2345表示23.45。
+ *     @arg 取值: -2147483648 - +2147483647
  * @param  Intlen 要显示的整数位数。
  *     @arg 取值: 1 - 10
  * @param  Declen 要显示的小数位数。
- *     @arg 取值: 1 - 10
+ *     @arg 取值: 0 - 9
  * @param  Size 字符大小。
  *     @arg 取值(宽x高): 6（6x8）、8（8x16）
  * @retval 无
  */
-void OLED_ShowFloat(uint8_t Line, uint8_t Column, float Num, uint8_t Intlen, uint8_t Declen, uint8_t Size)
+void OLED_ShowFixed(uint8_t Line, uint8_t Column, int32_t Num, uint8_t Intlen, uint8_t Declen, uint8_t Size)
 {
-    uint8_t p;
-    unsigned long m;
+    uint32_t Abs;
+    uint8_t i;
     if (Num < 0)
     {
-        Num = -Num;
+        Abs = -(uint32_t)Num;
         OLED_ShowChar(Line, Column, '-', Size);
-        OLED_ShowNum(Line, Column + Size, (uint32_t)Num, Intlen, Size);
-        if (Declen > 0)
-            OLED_ShowString(Line, Column + Size * (Intlen + 1), ".", Size);
-        for (p = 2, m = 10; p <= Declen + 1; p++, m *= 10)
-        {
-            OLED_ShowNum(Line, Column + Size * (Intlen + p), (unsigned long)((Num - (uint32_t)Num) * m) % 10, 1, Size);
-        }
+        Column += Size;
     }
     else
+        Abs = Num;
+    for (i = Declen; i > 0; i--) // 小数部分由低位向高位
     {
-        OLED_ShowNum(Line, Column, (uint32_t)Num, Intlen, Size);
-        if (Declen > 0)
-            OLED_ShowString(Line, Column + Intlen * Size, ".", Size);
-        for (p = 1, m = 10; p <= Declen; p++, m *= 10)
-        {
-            OLED_ShowNum(Line, Column + Size * (Intlen + p), (unsigned long)((Num - (uint32_t)Num) * m) % 10, 1, Size);
-        }
+        OLED_ShowChar(Line, Column + Size * (Intlen + i), Abs % 10 + '0', Size);
+        Abs /= 10;
     }
+    if (Declen > 0)
+        OLED_ShowChar(Line, Column + Intlen * Size, '.', Size);
+    OLED_ShowNum(Line, Column, Abs, Intlen, Size);
 }
 
 /**
@@ -524,10 +549,11 @@ void OLED_ShowSignedNum(uint8_t Line, uint8_t Column, int32_t Number, uint8_t Le
  */
 void OLED_ShowHexNum(uint8_t Line, uint8_t Column, uint32_t Number, uint8_t Length, uint8_t Size)
 {
-    uint8_t i, SingleNumber;
-    for (i = 0; i < Length; i++)
+    uint8_t i = Length, SingleNumber;
+    while (i--)
     {
-        SingleNumber = Number / OLED_Pow(16, Length - i - 1) % 16;
+        SingleNumber = Number & 0x0F;
+        Number >>= 4;
         if (SingleNumber < 10)
         {
             OLED_ShowChar(Line, Column + Size * i, SingleNumber + '0', Size);
@@ -555,10 +581,11 @@ void OLED_ShowHexNum(uint8_t Line, uint8_t Column, uint32_t Number, uint8_t Leng
  */
 void OLED_ShowBinNum(uint8_t Line, uint8_t Column, uint32_t Number, uint8_t Length, uint8_t Size)
 {
-    uint8_t i;
-    for (i = 0; i < Length; i++)
+    uint8_t i = Length;
+    while (i--)
     {
-        OLED_ShowChar(Line, Column + Size * i, Number / OLED_Pow(2, Length - i - 1) % 2 + '0', Size);
+        OLED_ShowChar(Line, Column + Size * i, (Number & 1) + '0', Size);
+        Number >>= 1;
     }
 }
 
@@ -576,15 +603,10 @@ void OLED_ShowCN(uint8_t Line, uint8_t Column, uint8_t Num)
     uint8_t i;
     uint8_t wide = 16; // 字宽
 
-    OLED_SetCursor(Line - 1, Column - 1); // 参数1:把光标设置在第几行. 参数2:把光标设置在第几列
-    for (i = 0; i < wide; i++)
-    {
-        OLED_WriteData(OLED_HzK[Num][i]); // 显示上半部分内容
-    }
-    OLED_SetCursor((Line - 1) + 1, Column - 1);
     for (i = 0; i < wide; i++)
     {
-        OLED_WriteData(OLED_HzK[Num][i + wide]); // 显示下半部分内容
+        OLED_GRAM_Write(Line - 1, Column - 1 + i, OLED_HzK[Num][i]);              // 上半部分内容
+        OLED_GRAM_Write((Line - 1) + 1, Column - 1 + i, OLED_HzK[Num][i + wide]); // 下半部分内容
     }
 }
 
@@ -612,10 +634,9 @@ void OLED_DrawBMP(uint8_t LineS, uint8_t LineE, uint8_t ColumnS, uint8_t ColumnE
         y = (LineE - 1) / 8 + 1;
     for (y = (LineS - 1); y <= (LineE - 1); y++)
     {
-        OLED_SetCursor(y, (ColumnS - 1));
         for (x = (ColumnS - 1); x <= (ColumnE - 1); x++)
         {
-            OLED_WriteData(BMP[j++]);
+            OLED_GRAM_Write(y, x, BMP[j++]);
         }
     }
 }
@@ -26,6 +26,15 @@ typedef unsigned int uint32_t;
 #define SCL_Pin GPIO_Pin_8 // PB8 -> SCL
 #define SDA_Pin GPIO_Pin_9 // PB9 -> SDA
 
+/**********************传输方式选择**********************/
+
+#define OLED_TRANSPORT_SIM 0  // 软件模拟I2C(GPIO翻转)
+#define OLED_TRANSPORT_I2C1 1 // 硬件I2C1(重映射PB8/PB9, 400kHz) + DMA1通道6后台刷新
+
+#ifndef OLED_TRANSPORT
+#define OLED_TRANSPORT OLED_TRANSPORT_I2C1
+#endif
+
 /**********************参数宏定义************************/
 
 #define Line1 0x00
@@ -40,6 +49,16 @@ typedef unsigned int uint32_t;
 #define ScrL 0x27
 #define ScrR 0x26
 
+// 总线流量统计开关. 1:统计OLED_BusBytes/OLED_BusTrans | 0:不统计
+#ifndef OLED_BUS_STAT
+#define OLED_BUS_STAT 0
+#endif
+
+#if OLED_BUS_STAT
+extern uint32_t OLED_BusBytes;
+extern uint32_t OLED_BusTrans;
+#endif
+
 /**********************函数声明************************/
 
 void Sim_I2C_Init(void);
@@ -50,21 +69,33 @@ void I2C_Send_Ack(uint8_t ack);
 uint8_t I2C_Read_Byte(uint8_t ack);
 void I2C_Send_Byte(uint8_t Byte);
 
+void OLED_Bus_Init(void);
+void OLED_WriteCommands(const uint8_t *Command, uint8_t Len);
+void OLED_WriteDataStream(const uint8_t *Data, uint16_t Len);
+uint8_t OLED_WriteWindowDMA(uint8_t Line, uint8_t Column, const uint8_t *Data, uint8_t Len);
+uint8_t OLED_Busy(void);
+
 void OLED_WriteCommand(uint8_t Command);
 void OLED_WriteData(uint8_t Data);
 void OLED_SetCursor(uint8_t Line, uint8_t Column);
+void OLED_WritePage(uint8_t Line, uint8_t Column, const uint8_t *Data, uint8_t Len);
 void OLED_Display_Off(void);
 void OLED_Display_On(void);
 void OLED_Clear(void);
+void OLED_ClearArea(uint8_t Line, uint8_t Column, uint8_t Height, uint8_t Width);
+void OLED_Refresh(void);
+#if OLED_TRANSPORT == OLED_TRANSPORT_I2C1
+void OLED_RefreshNext(uint8_t Failed);
+#endif
+void OLED_RefreshSync(void);
 void OLED_Scroll(uint8_t LineS, uint8_t LineE, uint8_t ScrLR, uint8_t Speed);
 void OLED_Stop_Scroll(void);
-uint32_t OLED_Pow(uint32_t X, uint32_t Y);
 void OLED_Init(void);
 
 void OLED_ShowChar(uint8_t Line, uint8_t Column, int8_t Char, uint8_t Size);
 void OLED_ShowString(uint8_t Line, uint8_t Column, char *String, uint8_t Size);
 void OLED_ShowNum(uint8_t Line, uint8_t Column, uint32_t Number, uint8_t Length, uint8_t Size);
-void OLED_ShowFloat(uint8_t Line, uint8_t Column, float Num, uint8_t Intlen, uint8_t Declen, uint8_t Size);
+void OLED_ShowFixed(uint8_t Line, uint8_t Column, int32_t Num, uint8_t Intlen, uint8_t Declen, uint8_t Size);
 void OLED_ShowSignedNum(uint8_t Line, uint8_t Column, int32_t Number, uint8_t Length, uint8_t Size);
 void OLED_ShowHexNum(uint8_t Line, uint8_t Column, uint32_t Number, uint8_t Length, uint8_t Size);
 void OLED_ShowBinNum(uint8_t Line, uint8_t Column, uint32_t Number, uint8_t Length, uint8_t Size);
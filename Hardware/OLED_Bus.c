@@ -0,0 +1,549 @@
+/**
+ ******************************************************************************
+ * @file    OLED_Bus.c
+ * @author  Blue_寻
+ * @brief   OLED屏幕总线传输(软件模拟I2C / 硬件I2C1+DMA), 显存与绘图见OLED.c
+ ******************************************************************************
+ */
+
+#include "stm32f10x.h"
+#include <string.h>
+#include "Tick.h"
+#include "OLED.h"
+
+#define I2C_ACK 0
+#define I2C_NO_ACK 1
+#define OLED_R_SDA() GPIO_ReadInputDataBit(GPIOX, SDA_Pin)
+#define OLED_W_SCL(x) GPIO_WriteBit(GPIOX, SCL_Pin, (BitAction)(x))
+#define OLED_W_SDA(x) GPIO_WriteBit(GPIOX, SDA_Pin, (BitAction)(x))
+
+#if OLED_BUS_STAT
+uint32_t OLED_BusBytes = 0; // 总线累计发送字节数(含从机地址与控制字节)
+uint32_t OLED_BusTrans = 0; // 总线累计传输次数(起始信号个数)
+#endif
+
+#if OLED_TRANSPORT == OLED_TRANSPORT_I2C1
+#define OLED_I2C_TIMEOUT 10000   // 查询方式等待I2C事件的最大查询次数
+#define OLED_I2C_STOP_POLLS 1000 // 发起始信号前等待停止信号结束(STOP位清零)的最大查询次数
+#define OLED_DMA_TIMEOUT_MS 20   // 后台传输的最长时间(一页141字节在400kHz下约3.2ms), 超时视为总线故障
+
+static volatile uint8_t OLED_DMA_Busy = 0; // DMA刷新进行中标志. 1:传输中 | 0:空闲
+static uint32_t OLED_DMA_Tick;             // 本次后台传输开始时刻, 毫秒
+#endif
+
+// 窗口写入的命令前缀: 以Co=1的单字节控制字节逐个发送列、页地址窗口命令, 最后以0x40转为连续数据
+static const uint8_t OLED_WindowPrefix[] = {0x80, 0x21, 0x80, 0, 0x80, 127, 0x80, 0x22, 0x80, 0, 0x80, 7, 0x40};
+static uint8_t OLED_TxBuf[sizeof(OLED_WindowPrefix) + 128]; // 窗口写入的发送缓冲区, DMA传输期间保持不变
+
+/**
+ * @brief  模拟I2C信号IO口初始化。
+ * @param  无
+ * @retval 无
+ */
+void Sim_I2C_Init(void)
+{
+    RCC_APB2PeriphClockCmd(APB2_GPIO, ENABLE);
+
+    GPIO_InitTypeDef GPIO_InitStructure;
+    GPIO_InitStructure.GPIO_Mode = GPIO_Mode_Out_OD;
+    GPIO_InitStructure.GPIO_Speed = GPIO_Speed_50MHz;
+
+    GPIO_InitStructure.GPIO_Pin = SCL_Pin;
+    GPIO_Init(GPIOX, &GPIO_InitStructure);
+
+    GPIO_InitStructure.GPIO_Pin = SDA_Pin;
+    GPIO_Init(GPIOX, &GPIO_InitStructure);
+
+    OLED_W_SCL(1);
+    OLED_W_SDA(1);
+}
+
+/**
+ * @brief  模拟I2C起始信号。
+ * @param  无
+ * @retval 无
+ */
+void Sim_I2C_Start(void)
+{
+#if OLED_BUS_STAT
+    OLED_BusTrans++;
+#endif
+    OLED_W_SDA(1);
+    OLED_W_SCL(1);
+    OLED_W_SDA(0);
+    OLED_W_SCL(0);
+}
+
+/**
+ * @brief  模拟I2C停止信号。
+ * @param  无
+ * @retval 无
+ */
+void Sim_I2C_Stop(void)
+{
+    OLED_W_SDA(0);
+    OLED_W_SCL(1);
+    OLED_W_SDA(1);
+}
+
+/**
+ * @brief  模拟I2C读取从机应答信号。
+ * @param  无
+ * @retval 从机应答状态，I2C_NO_ACK: 无应答，I2C_ACK: 应答。
+ */
+uint8_t I2C_Wait_Ack(void)
+{
+    uint8_t ack;
+    OLED_W_SCL(0);
+    OLED_W_SDA(1);
+    OLED_W_SCL(1);
+
+    if (OLED_R_SDA())
+        ack = I2C_NO_ACK;
+    else
+        ack = I2C_ACK;
+
+    OLED_W_SCL(0);
+    return ack;
+}
+
+/**
+ * @brief  模拟I2C主机发送应答信号。
+ * @param  ack 决定主机是否发送应答信号。
+ *     @arg I2C_ACK: 发送应答信号
+ *     @arg I2C_NO_ACK: 不发送应答信号
+ * @retval 无
+ */
+void I2C_Send_Ack(uint8_t ack)
+{
+    OLED_W_SCL(0);
+
+    if (ack == I2C_ACK)
+        OLED_W_SDA(0);
+    else
+        OLED_W_SDA(1);
+
+    OLED_W_SCL(1);
+    OLED_W_SCL(0);
+}
+
+/**
+ * @brief  I2C读取一个字节。
+ * @param  ack 决定主机是否发送应答信号。
+ *     @arg I2C_ACK: 发送应答信号
+ *     @arg I2C_NO_ACK: 不发送应答信号
+ * @retval data 读取到的数据
+ */
+uint8_t I2C_Read_Byte(uint8_t ack)
+{
+    uint8_t data = 0;
+    uint8_t i;
+    OLED_W_SCL(0);
+    OLED_W_SDA(1);
+    for (i = 0; i < 8; i++)
+    {
+        OLED_W_SCL(1);
+        data <<= 1;
+
+        if (OLED_R_SDA())
+            data |= 0x01;
+        else
+            data &= 0xFE;
+
+        OLED_W_SCL(0);
+    }
+    I2C_Send_Ack(ack);
+    return data;
+}
+
+/**
+ * @brief  I2C发送一个字节。
+ * @param  Byte  要发送的一个字节。
+ * @retval 无
+ */
+void I2C_Send_Byte(uint8_t Byte)
+{
+    uint8_t i;
+#if OLED_BUS_STAT
+    OLED_BusBytes++;
+#endif
+    for (i = 0; i < 8; i++)
+    {
+        OLED_W_SDA(Byte & (0x80 >> i));
+        OLED_W_SCL(1);
+        OLED_W_SCL(0);
+    }
+
+    // while(I2C_Wait_Ack());    //等待从机应答信号
+
+    OLED_W_SCL(1); // 变化时钟信号，不等待从机应答
+    OLED_W_SCL(0);
+}
+
+#if OLED_TRANSPORT == OLED_TRANSPORT_I2C1
+/*
+ * 硬件I2C1: 初始化命令等短传输以查询方式在主循环中发送; 显存刷新(窗口写入)在后台进行, 不在中断内查询等待:
+ * 起始信号后的SB、ADDR由I2C1事件中断处理, 控制字节与负载由DMA1通道6送入DR;
+ * DMA搬运完成中断只关闭通道并重新打开事件中断, 最后一个字节移出(BTF)后由事件中断发停止信号,
+ * 再由OLED_RefreshNext启动下一页. 总线错误由错误中断结束本次刷新, 总线无响应由OLED_Busy按超时结束.
+ */
+
+/**
+ * @brief  硬件I2C1及DMA1通道6初始化。
+ *         I2C1重映射至PB8(SCL)/PB9(SDA), 快速模式400kHz; DMA1通道6负责I2C1_TX。
+ * @param  无
+ * @retval 无
+ */
+static void OLED_I2C1_Init(void)
+{
+    RCC_APB2PeriphClockCmd(APB2_GPIO | RCC_APB2Periph_AFIO, ENABLE);
+    RCC_APB1PeriphClockCmd(RCC_APB1Periph_I2C1, ENABLE);
+    RCC_AHBPeriphClockCmd(RCC_AHBPeriph_DMA1, ENABLE);
+
+    GPIO_PinRemapConfig(GPIO_Remap_I2C1, ENABLE);
+
+    GPIO_InitTypeDef GPIO_InitStructure;
+    GPIO_InitStructure.GPIO_Mode = GPIO_Mode_AF_OD;
+    GPIO_InitStructure.GPIO_Pin = SCL_Pin | SDA_Pin;
+    GPIO_InitStructure.GPIO_Speed = GPIO_Speed_50MHz;
+    GPIO_Init(GPIOX, &GPIO_InitStructure);
+
+    I2C_InitTypeDef I2C_InitStructure;
+    I2C_InitStructure.I2C_Mode = I2C_Mode_I2C;
+    I2C_InitStructure.I2C_DutyCycle = I2C_DutyCycle_2;
+    I2C_InitStructure.I2C_OwnAddress1 = 0x00;
+    I2C_InitStructure.I2C_Ack = I2C_Ack_Enable;
+    I2C_InitStructure.I2C_AcknowledgedAddress = I2C_AcknowledgedAddress_7bit;
+    I2C_InitStructure.I2C_ClockSpeed = 400000;
+    I2C_Init(I2C1, &I2C_InitStructure);
+    I2C_Cmd(I2C1, ENABLE);
+
+    DMA_InitTypeDef DMA_InitStructure;
+    DMA_InitStructure.DMA_PeripheralBaseAddr = (uint32_t)&I2C1->DR;
+    DMA_InitStructure.DMA_MemoryBaseAddr = 0; // 每次传输前设置
+    DMA_InitStructure.DMA_DIR = DMA_DIR_PeripheralDST;
+    DMA_InitStructure.DMA_BufferSize = 0;
+    DMA_InitStructure.DMA_PeripheralInc = DMA_PeripheralInc_Disable;
+    DMA_InitStructure.DMA_MemoryInc = DMA_MemoryInc_Enable;
+    DMA_InitStructure.DMA_PeripheralDataSize = DMA_PeripheralDataSize_Byte;
+    DMA_InitStructure.DMA_MemoryDataSize = DMA_MemoryDataSize_Byte;
+    DMA_InitStructure.DMA_Mode = DMA_Mode_Normal;
+    DMA_InitStructure.DMA_Priority = DMA_Priority_Medium;
+    DMA_InitStructure.DMA_M2M = DMA_M2M_Disable;
+    DMA_Init(DMA1_Channel6, &DMA_InitStructure);
+    DMA_ITConfig(DMA1_Channel6, DMA_IT_TC, ENABLE);
+
+    NVIC_PriorityGroupConfig(NVIC_PriorityGroup_2);
+
+    // DMA、I2C1事件与错误中断同一抢占优先级, 互不打断
+    NVIC_InitTypeDef NVIC_InitStructure;
+    NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
+    NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = 2;
+    NVIC_InitStructure.NVIC_IRQChannelSubPriority = 0;
+    NVIC_InitStructure.NVIC_IRQChannel = DMA1_Channel6_IRQn;
+    NVIC_Init(&NVIC_InitStructure);
+    NVIC_InitStructure.NVIC_IRQChannel = I2C1_EV_IRQn;
+    NVIC_Init(&NVIC_InitStructure);
+    NVIC_InitStructure.NVIC_IRQChannel = I2C1_ER_IRQn;
+    NVIC_Init(&NVIC_InitStructure);
+}
+
+/**
+ * @brief  等待I2C1事件, 超时则发送停止信号。
+ * @param  Event I2C事件, 参见stm32f10x_i2c.h中I2C_EVENT_xxx。
+ * @retval 0:事件已发生 | 1:等待超时
+ */
+static uint8_t OLED_I2C1_WaitEvent(uint32_t Event)
+{
+    uint32_t Timeout = OLED_I2C_TIMEOUT;
+    while (I2C_CheckEvent(I2C1, Event) != SUCCESS)
+    {
+        if (--Timeout == 0)
+        {
+            I2C_GenerateSTOP(I2C1, ENABLE);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief  等待上一次传输的停止信号发出(STOP位由硬件清零)。STOP位为1时写CR1可能再次置位STOP,
+ *         因此发起始信号前须先等待。总线由本机占用时停止信号在一个SCL周期(2.5us)内发出, 查询次数有上限
+ * @param  无
+ * @retval 0:停止信号已发出 | 1:超时
+ */
+static uint8_t OLED_I2C1_WaitStop(void)
+{
+    uint16_t n = OLED_I2C_STOP_POLLS;
+    while (I2C1->CR1 & I2C_CR1_STOP)
+    {
+        if (--n == 0)
+            return 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief  硬件I2C1发送起始信号、从机地址和控制字节(查询方式)。
+ * @param  Control 控制字节. 0x00:写命令 | 0x40:写数据
+ * @retval 0:成功 | 1:总线超时
+ */
+static uint8_t OLED_I2C1_Begin(uint8_t Control)
+{
+    while (OLED_Busy()) // 等待上一次后台刷新结束
+        ;
+
+#if OLED_BUS_STAT
+    OLED_BusTrans++;
+    OLED_BusBytes += 2;
+#endif
+    if (OLED_I2C1_WaitStop())
+        return 1;
+    I2C_GenerateSTART(I2C1, ENABLE);
+    if (OLED_I2C1_WaitEvent(I2C_EVENT_MASTER_MODE_SELECT))
+        return 1;
+    I2C_Send7bitAddress(I2C1, 0x78, I2C_Direction_Transmitter); // 从机地址
+    if (OLED_I2C1_WaitEvent(I2C_EVENT_MASTER_TRANSMITTER_MODE_SELECTED))
+        return 1;
+    I2C_SendData(I2C1, Control);
+    return 0;
+}
+
+/**
+ * @brief  硬件I2C1以查询方式发送一段字节并结束本次传输。
+ * @param  Control 控制字节. 0x00:写命令 | 0x40:写数据
+ * @param  Buf 待发送字节数组。
+ * @param  Len 字节数。
+ * @retval 无
+ */
+static void OLED_I2C1_Write(uint8_t Control, const uint8_t *Buf, uint16_t Len)
+{
+    if (OLED_I2C1_Begin(Control))
+        return;
+#if OLED_BUS_STAT
+    OLED_BusBytes += Len;
+#endif
+    while (Len--)
+    {
+        if (OLED_I2C1_WaitEvent(I2C_EVENT_MASTER_BYTE_TRANSMITTING))
+            return;
+        I2C_SendData(I2C1, *Buf++);
+    }
+    if (OLED_I2C1_WaitEvent(I2C_EVENT_MASTER_BYTE_TRANSMITTED))
+        return;
+    I2C_GenerateSTOP(I2C1, ENABLE);
+}
+
+/**
+ * @brief  启动一次后台传输并立即返回: 预置DMA后发起始信号, 其后各步骤在中断内完成。
+ *         可在中断内调用(由上一页的事件中断启动下一页)。
+ * @param  Buf 控制字节及其后的负载, 传输期间须保持不变。
+ * @param  Len 字节数(含控制字节)。
+ * @retval 0:已启动 | 1:上一次的停止信号未结束, 未启动
+ */
+static uint8_t OLED_I2C1_WriteDMA(const uint8_t *Buf, uint16_t Len)
+{
+    if (OLED_I2C1_WaitStop())
+        return 1;
+#if OLED_BUS_STAT
+    OLED_BusTrans++;
+    OLED_BusBytes += 1 + Len;
+#endif
+
+    OLED_DMA_Busy = 1;
+    OLED_DMA_Tick = Tick_Get();
+    DMA_Cmd(DMA1_Channel6, DISABLE);
+    DMA1_Channel6->CMAR = (uint32_t)Buf;
+    DMA_SetCurrDataCounter(DMA1_Channel6, Len);
+    DMA_Cmd(DMA1_Channel6, ENABLE);
+    I2C_DMACmd(I2C1, ENABLE); // 地址发送完成(ADDR清除)后TxE置位, DMA开始搬运
+    I2C_ITConfig(I2C1, I2C_IT_EVT | I2C_IT_ERR, ENABLE);
+    I2C_GenerateSTART(I2C1, ENABLE);
+    return 0;
+}
+
+/**
+ * @brief  结束后台传输: 关闭DMA与I2C1中断, 由OLED_RefreshNext启动下一页或结束本次刷新。
+ *         在中断内调用, 或在主循环中关中断后调用
+ * @param  Failed 1:总线错误或超时, 发送停止信号并结束本次刷新 | 0:本页已发送
+ * @retval 无
+ */
+static void OLED_I2C1_End(uint8_t Failed)
+{
+    I2C_ITConfig(I2C1, I2C_IT_EVT | I2C_IT_ERR, DISABLE);
+    DMA_Cmd(DMA1_Channel6, DISABLE);
+    I2C_DMACmd(I2C1, DISABLE);
+    if (Failed)
+        I2C_GenerateSTOP(I2C1, ENABLE);
+    OLED_DMA_Busy = 0;
+    OLED_RefreshNext(Failed);
+}
+
+/**
+ * @brief  I2C1事件中断: SB后发送从机地址; ADDR后清除ADDR, 关闭事件中断由DMA搬运;
+ *         DMA搬运完成后再次打开事件中断, BTF(最后一个字节已移出)时发送停止信号并启动下一页。
+ * @param  无
+ * @retval 无
+ */
+void I2C1_EV_IRQHandler(void)
+{
+    if (I2C_GetFlagStatus(I2C1, I2C_FLAG_SB) != RESET) // 读SR1后写DR清除SB
+    {
+        I2C_Send7bitAddress(I2C1, 0x78, I2C_Direction_Transmitter);
+    }
+    else if (I2C_GetFlagStatus(I2C1, I2C_FLAG_ADDR) != RESET)
+    {
+        (void)I2C1->SR2; // 读SR1后读SR2清除ADDR
+        I2C_ITConfig(I2C1, I2C_IT_EVT, DISABLE); // 搬运期间DMA稍慢时BTF会短暂置位, 不应进入中断
+    }
+    else if (I2C_GetFlagStatus(I2C1, I2C_FLAG_BTF) != RESET)
+    {
+        I2C_GenerateSTOP(I2C1, ENABLE); // 清除BTF
+        OLED_I2C1_End(0);
+    }
+}
+
+/**
+ * @brief  I2C1错误中断: 应答失败、总线错误或仲裁丢失时结束本次刷新, 未发出的区间留待下一次刷新。
+ * @param  无
+ * @retval 无
+ */
+void I2C1_ER_IRQHandler(void)
+{
+    I2C_ClearITPendingBit(I2C1, I2C_IT_AF | I2C_IT_BERR | I2C_IT_ARLO);
+    if (OLED_DMA_Busy)
+        OLED_I2C1_End(1);
+}
+
+/**
+ * @brief  DMA1通道6中断: 显存数据搬运完成, 关闭通道并打开I2C1事件中断, 等待最后一个字节移出(BTF)。
+ * @param  无
+ * @retval 无
+ */
+void DMA1_Channel6_IRQHandler(void)
+{
+    if (DMA_GetITStatus(DMA1_IT_TC6) != RESET)
+    {
+        DMA_ClearITPendingBit(DMA1_IT_TC6);
+        DMA_Cmd(DMA1_Channel6, DISABLE);
+        I2C_DMACmd(I2C1, DISABLE);
+        I2C_ITConfig(I2C1, I2C_IT_EVT, ENABLE);
+    }
+}
+#endif
+
+/**
+ * @brief  OLED总线初始化, 按OLED_TRANSPORT选择软件I2C或硬件I2C1+DMA。
+ * @param  无
+ * @retval 无
+ */
+void OLED_Bus_Init(void)
+{
+#if OLED_TRANSPORT == OLED_TRANSPORT_I2C1
+    OLED_I2C1_Init(); // 硬件I2C1及DMA初始化
+#else
+    Sim_I2C_Init(); // 端口初始化
+#endif
+}
+
+/**
+ * @brief  在一次I2C传输内向OLED屏连续发送多条命令。
+ * @param  Command 命令数组。
+ * @param  Len 命令字节数。
+ * @retval 无
+ */
+void OLED_WriteCommands(const uint8_t *Command, uint8_t Len)
+{
+#if OLED_TRANSPORT == OLED_TRANSPORT_I2C1
+    OLED_I2C1_Write(0x00, Command, Len);
+#else
+    Sim_I2C_Start();
+    I2C_Send_Byte(0x78); // 从机地址
+    I2C_Send_Byte(0x00); // 写命令(Co=0, 后续字节均为命令)
+    while (Len--)
+    {
+        I2C_Send_Byte(*Command++);
+    }
+    Sim_I2C_Stop();
+#endif
+}
+
+/**
+ * @brief  在一次I2C传输内向OLED屏连续发送多个数据字节。
+ *         屏幕列地址在每个字节后自动加1。
+ * @param  Data 数据数组。
+ * @param  Len 数据字节数。
+ * @retval 无
+ */
+void OLED_WriteDataStream(const uint8_t *Data, uint16_t Len)
+{
+#if OLED_TRANSPORT == OLED_TRANSPORT_I2C1
+    OLED_I2C1_Write(0x40, Data, Len);
+#else
+    Sim_I2C_Start();
+    I2C_Send_Byte(0x78); // 从机地址
+    I2C_Send_Byte(0x40); // 写数据(Co=0, 后续字节均为数据)
+    while (Len--)
+    {
+        I2C_Send_Byte(*Data++);
+    }
+    Sim_I2C_Stop();
+#endif
+}
+
+/**
+ * @brief  在一次I2C传输内设置光标并发送一段显存数据: 数据连同光标命令复制到发送缓冲区,
+ *         命令以单字节控制字节前缀(Co=1), 数据以连续数据控制字节前缀。
+ *         硬件I2C1: 由DMA在后台发送, 函数立即返回, 调用后Data即可改动;
+ *         软件I2C: 函数返回时发送已完成。
+ * @param  Line 行（页）地址。
+ *     @arg 取值: 0 - 7
+ * @param  Column 起始列地址。
+ *     @arg 取值: 0 - 127
+ * @param  Data 数据起始地址。
+ * @param  Len 数据字节数, 不应超过该页剩余列数。
+ * @retval 0:已启动(或已完成) | 1:总线超时, 未发送
+ */
+uint8_t OLED_WriteWindowDMA(uint8_t Line, uint8_t Column, const uint8_t *Data, uint8_t Len)
+{
+    memcpy(OLED_TxBuf, OLED_WindowPrefix, sizeof(OLED_WindowPrefix));
+    OLED_TxBuf[3] = Column;
+    OLED_TxBuf[9] = Line;
+    memcpy(OLED_TxBuf + sizeof(OLED_WindowPrefix), Data, Len);
+#if OLED_TRANSPORT == OLED_TRANSPORT_I2C1
+    return OLED_I2C1_WriteDMA(OLED_TxBuf, sizeof(OLED_WindowPrefix) + Len);
+#else
+    uint16_t i;
+
+    Sim_I2C_Start();
+    I2C_Send_Byte(0x78); // 从机地址
+    for (i = 0; i < sizeof(OLED_WindowPrefix) + Len; i++)
+    {
+        I2C_Send_Byte(OLED_TxBuf[i]);
+    }
+    Sim_I2C_Stop();
+    return 0;
+#endif
+}
+
+/**
+ * @brief  查询后台传输状态。
+ * @param  无
+ * @retval 1:DMA传输进行中 | 0:空闲(软件I2C下恒为0). 后台传输超时时结束本次刷新并返回0
+ */
+uint8_t OLED_Busy(void)
+{
+#if OLED_TRANSPORT == OLED_TRANSPORT_I2C1
+    if (OLED_DMA_Busy && (Tick_Get() - OLED_DMA_Tick > OLED_DMA_TIMEOUT_MS)) // 总线无响应, 不再有中断结束传输
+    {
+        __disable_irq();
+        if (OLED_DMA_Busy)
+            OLED_I2C1_End(1);
+        __enable_irq();
+    }
+    return OLED_DMA_Busy;
+#else
+    return 0;
+#endif
+}
@@ -0,0 +1,509 @@
+#include "stm32f10x.h"
+#include "Delay.h"
+#include "Tick.h"
+#include "OneWire.h"
+
+/*
+ * 单总线(1-Wire)位时隙层: 复位与存在脉冲、读写时隙, 传输方式由ONEWIRE_TRANSPORT选择。
+ * ROM命令与器件功能命令在DS18B20.c中实现。
+ */
+
+#if ONEWIRE_TRANSPORT == ONEWIRE_TRANSPORT_USART2
+
+/*
+ * USART2半双工: TX引脚PA2开漏复用输出并作为单总线, RX在内部连接到同一引脚, 每发送一个字节即产生一个时隙并收到回读。
+ * 时隙以115200波特率收发: 发0xFF为写1/读时隙(起始位低电平8.7us后释放, 接收器在13us处采样第0位),
+ * 器件应答0时拉低总线使回读不为0xFF; 发0x00为写0时隙(起始位与8个数据位共78us低电平)。
+ * 复位以9600波特率发0xF0(低电平520us), 器件的存在脉冲使回读不为0xF0。
+ * 时隙波形由USART产生, 不受中断影响. 接收中断取走一个时隙的回读, 把读到的位写回数据, 再发送下一时隙字节;
+ * 中断响应延迟只延长时隙之间的总线空闲时间(单总线对此没有上限), 因此接收中断使用最低优先级。
+ * OneWire_TouchStart启动传输后立即返回, 调用者以OneWire_TouchDone查询, 其间CPU只在每个时隙(87us)进入一次中断。
+ */
+
+#define ONEWIRE_BAUD_RESET 9600  // 复位与存在脉冲
+#define ONEWIRE_BAUD_SLOT 115200 // 读写时隙
+
+static uint8_t *OneWire_Data;         // 本次传输的数据, 回读逐位写回
+static uint16_t OneWire_SlotN;        // 本次传输的时隙数
+static volatile uint16_t OneWire_RxN; // 已收到的回读数
+static uint32_t OneWire_Start;        // 传输开始时刻, 毫秒
+static uint32_t OneWire_PCLK;         // USART2时钟, Hz
+
+/**
+ * @brief  等待发送完成后切换波特率
+ * @param  Baud 波特率
+ * @retval 无
+ */
+static void OneWire_SetBaud(uint32_t Baud)
+{
+	while (USART_GetFlagStatus(USART2, USART_FLAG_TC) == RESET);
+	USART2->BRR = (OneWire_PCLK + Baud / 2) / Baud;
+}
+
+/**
+ * @brief  数据中第n个时隙的时隙字节
+ * @param  n 时隙序号, 每字节低位在前
+ * @retval 0xFF:写1/读时隙 | 0x00:写0时隙
+ */
+static __INLINE uint8_t OneWire_SlotByte(uint16_t n)
+{
+	return (OneWire_Data[n / 8] >> (n % 8)) & 0x01 ? 0xFF : 0x00;
+}
+
+/**
+ * @brief  启动N个时隙的传输, 立即返回
+ * @param  Data 数据, 传输结束前须保持有效
+ * @param  N 时隙数
+ * @retval 无
+ */
+static void OneWire_Begin(uint8_t *Data, uint16_t N)
+{
+	OneWire_Data = Data;
+	OneWire_SlotN = N;
+	OneWire_RxN = 0;
+	OneWire_Start = Tick_Get();
+	if (N == 0)
+		return;
+	USART_ReceiveData(USART2); // 丢弃上次超时传输残留的回读
+	USART_ITConfig(USART2, USART_IT_RXNE, ENABLE);
+	USART_SendData(USART2, OneWire_SlotByte(0));
+}
+
+/**
+ * @brief  等待传输结束(等待期间休眠)并结束传输
+ * @param  无
+ * @retval 1:超时(回读丢失) | 0:完成
+ */
+static uint8_t OneWire_Wait(void)
+{
+	while (1)
+	{
+		__disable_irq();
+		if (OneWire_TouchDone())
+			break;
+		__WFI(); // 关中断休眠: 检查之后到达的中断同样能唤醒, 不会错过最后一个回读
+		__enable_irq();
+	}
+	__enable_irq();
+	return OneWire_TouchEnd();
+}
+
+/**
+ * @brief  初始化USART2为半双工单总线主机。PA2
+ * @param  无
+ * @retval 无
+ */
+void OneWire_Init(void)
+{
+	RCC_ClocksTypeDef Clocks;
+
+	RCC_APB1PeriphClockCmd(RCC_APB1Periph_USART2, ENABLE);
+	RCC_APB2PeriphClockCmd(RCC_APB2Periph_GPIOA, ENABLE);
+
+	GPIO_InitTypeDef GPIO_InitStructure;
+	GPIO_InitStructure.GPIO_Mode = GPIO_Mode_AF_OD;
+	GPIO_InitStructure.GPIO_Pin = GPIO_Pin_2;
+	GPIO_InitStructure.GPIO_Speed = GPIO_Speed_50MHz;
+	GPIO_Init(GPIOA, &GPIO_InitStructure);
+
+	USART_InitTypeDef USART_InitStructure;
+	USART_InitStructure.USART_BaudRate = ONEWIRE_BAUD_SLOT;
+	USART_InitStructure.USART_HardwareFlowControl = USART_HardwareFlowControl_None;
+	USART_InitStructure.USART_Mode = USART_Mode_Rx | USART_Mode_Tx;
+	USART_InitStructure.USART_Parity = USART_Parity_No;
+	USART_InitStructure.USART_StopBits = USART_StopBits_1;
+	USART_InitStructure.USART_WordLength = USART_WordLength_8b;
+	USART_Init(USART2, &USART_InitStructure);
+	USART_HalfDuplexCmd(USART2, ENABLE);
+	RCC_GetClocksFreq(&Clocks);
+	OneWire_PCLK = Clocks.PCLK1_Frequency;
+
+	NVIC_PriorityGroupConfig(NVIC_PriorityGroup_2);
+	NVIC_InitTypeDef NVIC_InitStructure;
+	NVIC_InitStructure.NVIC_IRQChannel = USART2_IRQn;
+	NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
+	NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = 3; // 下一时隙由中断发出, 响应延迟不破坏时序
+	NVIC_InitStructure.NVIC_IRQChannelSubPriority = 0;
+	NVIC_Init(&NVIC_InitStructure);
+
+	USART_Cmd(USART2, ENABLE);
+}
+
+/**
+ * @brief  复位总线并检测存在脉冲(查询等待, 约1ms)。
+ * @param  无
+ * @retval Resetflag 复位标志，总线上无器件应答(故障或未连接)时返回值为1，反之为0
+ */
+uint8_t OneWire_Reset(void)
+{
+	uint32_t Start = Tick_Get();
+	uint8_t Echo = 0xF0;
+
+	OneWire_SetBaud(ONEWIRE_BAUD_RESET);
+	USART_ReceiveData(USART2);
+	USART_SendData(USART2, 0xF0);
+	while ((USART_GetFlagStatus(USART2, USART_FLAG_RXNE) == RESET) && (Tick_Get() - Start <= 2));
+	if (USART_GetFlagStatus(USART2, USART_FLAG_RXNE) != RESET)
+		Echo = USART_ReceiveData(USART2);
+	OneWire_SetBaud(ONEWIRE_BAUD_SLOT);
+	return Echo == 0xF0;
+}
+
+/**
+ * @brief  启动若干时隙的收发, 立即返回: 每字节低位在前, 写入位为1的时隙同时是读时隙, 读到的位写回原处。
+ *         之后以OneWire_TouchDone查询, 结束后调用OneWire_TouchEnd, 其间不得访问总线。
+ * @param  Data 数据, 输入写入的字节, 结束后为读到的字节; 传输结束前须保持有效
+ * @param  Len 字节数
+ * @retval 无
+ */
+void OneWire_TouchStart(uint8_t *Data, uint8_t Len)
+{
+	OneWire_Begin(Data, Len * 8);
+}
+
+/**
+ * @brief  查询OneWire_TouchStart启动的传输是否结束(完成或超时)
+ * @param  无
+ * @retval 1:结束 | 0:传输中
+ */
+uint8_t OneWire_TouchDone(void)
+{
+	// 每时隙约87us加中断响应延迟, 按125us计并留2ms余量
+	return (OneWire_RxN >= OneWire_SlotN) || (Tick_Get() - OneWire_Start > 2u + OneWire_SlotN / 8);
+}
+
+/**
+ * @brief  结束传输
+ * @param  无
+ * @retval 1:传输超时(回读丢失) | 0:成功
+ */
+uint8_t OneWire_TouchEnd(void)
+{
+	USART_ITConfig(USART2, USART_IT_RXNE, DISABLE);
+	return OneWire_RxN < OneWire_SlotN;
+}
+
+/**
+ * @brief  以若干时隙收发数据(等待结束), 规则同OneWire_TouchStart。
+ * @param  Data 数据, 输入写入的字节, 输出读到的字节
+ * @param  Len 字节数
+ * @retval 1:传输超时 | 0:成功
+ */
+uint8_t OneWire_Touch(uint8_t *Data, uint8_t Len)
+{
+	OneWire_TouchStart(Data, Len);
+	return OneWire_Wait();
+}
+
+/**
+ * @brief  写时隙, 写入一位。
+ * @param  Bit 0或1
+ * @retval 无
+ */
+void OneWire_WriteBit(uint8_t Bit)
+{
+	uint8_t Data = Bit ? 1 : 0;
+
+	OneWire_Begin(&Data, 1);
+	OneWire_Wait();
+}
+
+/**
+ * @brief  读时隙, 读取一位。
+ * @param  无
+ * @retval 读到的位, 传输超时时为1
+ */
+uint8_t OneWire_ReadBit(void)
+{
+	uint8_t Data = 1;
+
+	OneWire_Begin(&Data, 1);
+	if (OneWire_Wait())
+		return 1;
+	return Data & 0x01;
+}
+
+/**
+ * @brief  写入一个字节, 低位在前。
+ * @param  Data 数据
+ * @retval 无
+ */
+void OneWire_WriteByte(uint8_t Data)
+{
+	OneWire_Touch(&Data, 1);
+}
+
+/**
+ * @brief  读取一个字节, 低位在前。
+ * @param  无
+ * @retval 读到的字节, 传输超时时为0xFF
+ */
+uint8_t OneWire_ReadByte(void)
+{
+	uint8_t Data = 0xFF;
+
+	if (OneWire_Touch(&Data, 1))
+		return 0xFF;
+	return Data;
+}
+
+/**
+ * @brief  USART2接收中断: 取走一个时隙的回读写回数据, 发送下一时隙字节
+ * @param  无
+ * @retval 无
+ */
+void USART2_IRQHandler(void)
+{
+	uint16_t n = OneWire_RxN;
+
+	if (USART_GetITStatus(USART2, USART_IT_RXNE) != RESET)
+	{
+		if (USART_ReceiveData(USART2) == 0xFF) // 读DR同时清除RXNE与溢出标志
+			OneWire_Data[n / 8] |= 1 << (n % 8);
+		else
+			OneWire_Data[n / 8] &= ~(1 << (n % 8));
+		OneWire_RxN = ++n;
+		if (n < OneWire_SlotN)
+			USART_SendData(USART2, OneWire_SlotByte(n));
+		else
+			USART_ITConfig(USART2, USART_IT_RXNE, DISABLE);
+	}
+}
+
+#else
+
+/*
+ * GPIO位翻转: PB0初始化时配置一次为开漏输出, 由外部上拉电阻(4.7kΩ)拉高: 输出1即释放总线, 释放时IDR读到的就是总线电平,
+ * 时隙中不再切换输入/输出模式。引脚直接经BSRR/BRR/IDR访问。
+ * 时隙内各时刻以DWT周期计数相对时隙起点计算, 不累积误差; 对时序敏感的区间关中断: 写1/读时隙为拉低到采样,
+ * 写0时隙为拉低到释放(ONEWIRE_LOW_0, 中断延长低电平会超过120us的上限)。中断只能落在总线释放之后,
+ * 使时隙变长而不破坏时序; 代价是写0时隙关中断约62us。
+ */
+
+#define DQ_H (GPIOB->BSRR = GPIO_Pin_0)             // 释放总线
+#define DQ_L (GPIOB->BRR = GPIO_Pin_0)              // 拉低总线
+#define DQ_Get ((GPIOB->IDR & GPIO_Pin_0) ? 1 : 0) // 总线电平
+
+// 时隙时刻, 相对时隙起点, 微秒
+#define ONEWIRE_RESET_LOW  480 // 复位脉冲宽度
+#define ONEWIRE_PRESENCE   70  // 释放后采样存在脉冲的时刻(存在脉冲在释放后15-60us开始, 持续60-240us)
+#define ONEWIRE_RESET_SLOT 480 // 释放后等待存在脉冲结束的时刻
+#define ONEWIRE_LOW_1      2   // 写1/读时隙的低电平宽度(1-15us)
+#define ONEWIRE_SAMPLE     12  // 读时隙采样时刻(须早于15us)
+#define ONEWIRE_LOW_0      62  // 写0时隙的低电平宽度(60-120us)
+#define ONEWIRE_SLOT       65  // 时隙长度(含至少1us恢复时间)
+
+static uint32_t OneWire_Cycles; // 每微秒的周期数
+
+#if ONEWIRE_STAT
+OneWire_StatTypeDef OneWire_Stat = {0, 0xFFFFFFFF, 0, {0, 0}, 0};
+#endif
+
+/**
+ * @brief  等待至时隙起点之后的指定时刻。
+ * @param  Start 时隙起点的周期计数
+ * @param  us 相对时隙起点的时刻, 微秒
+ * @retval 无
+ */
+static __INLINE void OneWire_Until(uint32_t Start, uint32_t us)
+{
+	uint32_t Cycles = us * OneWire_Cycles;
+	while (DWT_CYCCNT - Start < Cycles);
+}
+
+/**
+ * @brief  一个读/写时隙: 拉低总线, 写1或读时在ONEWIRE_LOW_1后释放并在ONEWIRE_SAMPLE采样, 写0时保持低电平至ONEWIRE_LOW_0。
+ *         写0时隙在释放总线前不开中断
+ * @param  Bit 写入的位, 读时隙写1
+ * @retval 采样到的总线电平(写0时为0)
+ */
+static __INLINE uint8_t OneWire_Slot(uint8_t Bit)
+{
+	uint32_t Start, Release, Sample;
+	uint8_t Line;
+
+	__disable_irq();
+	Start = DWT_CYCCNT;
+	DQ_L;
+	OneWire_Until(Start, ONEWIRE_LOW_1);
+	if (Bit)
+		DQ_H;
+	Release = DWT_CYCCNT - Start;
+	OneWire_Until(Start, ONEWIRE_SAMPLE);
+	Line = DQ_Get;
+	Sample = DWT_CYCCNT - Start;
+	if (Bit)
+		__enable_irq(); // 总线已释放, 其后的中断只延长时隙
+	else
+	{
+		OneWire_Until(Start, ONEWIRE_LOW_0);
+		DQ_H;
+		Release = DWT_CYCCNT - Start;
+		__enable_irq();
+	}
+	OneWire_Until(Start, ONEWIRE_SLOT);
+
+#if ONEWIRE_STAT
+	OneWire_Stat.Slots++;
+	if (Sample < OneWire_Stat.SampleMin)
+		OneWire_Stat.SampleMin = Sample;
+	if (Sample > OneWire_Stat.SampleMax)
+		OneWire_Stat.SampleMax = Sample;
+	if (Release > OneWire_Stat.LowMax[Bit])
+		OneWire_Stat.LowMax[Bit] = Release;
+	if ((Sample >= 15 * OneWire_Cycles) || (Release >= (Bit ? 15 : 120) * OneWire_Cycles))
+		OneWire_Stat.Late++;
+#else
+	(void)Release;
+	(void)Sample;
+#endif
+	return Line;
+}
+
+/**
+ * @brief  初始化单总线通信IO口为开漏输出并释放总线。PB0
+ * @param  无
+ * @retval 无
+ */
+void OneWire_Init(void)
+{
+	GPIO_InitTypeDef GPIO_InitStructure;
+
+	RCC_APB2PeriphClockCmd(RCC_APB2Periph_GPIOB, ENABLE);
+	DQ_H;
+	GPIO_InitStructure.GPIO_Mode = GPIO_Mode_Out_OD;
+	GPIO_InitStructure.GPIO_Pin = GPIO_Pin_0;
+	GPIO_InitStructure.GPIO_Speed = GPIO_Speed_50MHz;
+	GPIO_Init(GPIOB, &GPIO_InitStructure);
+	OneWire_Cycles = SystemCoreClock / 1000000;
+}
+
+/**
+ * @brief  复位总线并检测存在脉冲。
+ * @param  无
+ * @retval Resetflag 复位标志，总线上无器件应答(故障或未连接)时返回值为1，反之为0
+ */
+uint8_t OneWire_Reset(void)
+{
+	uint32_t Start;
+	uint8_t Resetflag;
+
+	Start = DWT_CYCCNT;
+	DQ_L;
+	OneWire_Until(Start, ONEWIRE_RESET_LOW); // 复位脉冲被中断拉长不影响时序
+	__disable_irq();
+	Start = DWT_CYCCNT;
+	DQ_H;
+	OneWire_Until(Start, ONEWIRE_PRESENCE);
+	Resetflag = DQ_Get;
+	__enable_irq();
+	OneWire_Until(Start, ONEWIRE_RESET_SLOT);
+	return Resetflag;
+}
+
+/**
+ * @brief  写时隙, 写入一位。
+ * @param  Bit 0或1
+ * @retval 无
+ */
+void OneWire_WriteBit(uint8_t Bit)
+{
+	OneWire_Slot(Bit ? 1 : 0);
+}
+
+/**
+ * @brief  读时隙, 读取一位。
+ * @param  无
+ * @retval 读到的位
+ */
+uint8_t OneWire_ReadBit(void)
+{
+	return OneWire_Slot(1);
+}
+
+/**
+ * @brief  写入一个字节, 低位在前。
+ * @param  Data 数据
+ * @retval 无
+ */
+void OneWire_WriteByte(uint8_t Data)
+{
+	for (uint8_t i = 0; i < 8; i++)
+	{
+		OneWire_Slot(Data & 0x01);
+		Data = Data >> 1;
+	}
+}
+
+/**
+ * @brief  读取一个字节, 低位在前。
+ * @param  无
+ * @retval 读到的字节
+ */
+uint8_t OneWire_ReadByte(void)
+{
+	uint8_t Data = 0;
+
+	for (uint8_t i = 0; i < 8; i++)
+	{
+		Data = Data >> 1;
+		if (OneWire_Slot(1))
+			Data |= 0x80;
+	}
+	return Data;
+}
+
+/**
+ * @brief  以若干时隙收发数据: 每字节低位在前, 写入位为1的时隙同时是读时隙, 读到的位写回原处。
+ *         读取时写入0xFF; 只写时回读与写入相同。
+ * @param  Data 数据, 输入写入的字节, 输出读到的字节
+ * @param  Len 字节数
+ * @retval 0
+ */
+uint8_t OneWire_Touch(uint8_t *Data, uint8_t Len)
+{
+	uint8_t i, j, Byte;
+
+	for (i = 0; i < Len; i++)
+	{
+		Byte = 0;
+		for (j = 0; j < 8; j++)
+			if (OneWire_Slot((Data[i] >> j) & 0x01))
+				Byte |= 1 << j;
+		Data[i] = Byte;
+	}
+	return 0;
+}
+
+/**
+ * @brief  收发数据, 规则同OneWire_Touch。GPIO方式由CPU产生时隙, 返回时传输已完成。
+ * @param  Data 数据, 输入写入的字节, 输出读到的字节
+ * @param  Len 字节数
+ * @retval 无
+ */
+void OneWire_TouchStart(uint8_t *Data, uint8_t Len)
+{
+	OneWire_Touch(Data, Len);
+}
+
+/**
+ * @brief  查询OneWire_TouchStart启动的传输是否结束
+ * @param  无
+ * @retval 1
+ */
+uint8_t OneWire_TouchDone(void)
+{
+	return 1;
+}
+
+/**
+ * @brief  结束传输
+ * @param  无
+ * @retval 0
+ */
+uint8_t OneWire_TouchEnd(void)
+{
+	return 0;
+}
+
+#endif
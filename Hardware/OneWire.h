@@ -0,0 +1,42 @@
+#ifndef __ONEWIRE_H
+#define __ONEWIRE_H
+
+/**********************传输方式选择**********************/
+
+#define ONEWIRE_TRANSPORT_GPIO 0   // PB0开漏, CPU以DWT计时翻转引脚
+#define ONEWIRE_TRANSPORT_USART2 1 // PA2, USART2半双工, 时隙波形由USART产生, 传输可异步进行
+
+#ifndef ONEWIRE_TRANSPORT
+#define ONEWIRE_TRANSPORT ONEWIRE_TRANSPORT_GPIO
+#endif
+
+// 时隙时序统计开关(仅GPIO方式). 1:以DWT周期计数测量各时隙的释放与采样时刻, 记录于OneWire_Stat | 0:不统计
+#ifndef ONEWIRE_STAT
+#define ONEWIRE_STAT 0
+#endif
+
+#if ONEWIRE_STAT
+typedef struct
+{
+	uint32_t Slots;      // 时隙数
+	uint32_t SampleMin;  // 采样时刻最小值, 周期
+	uint32_t SampleMax;  // 采样时刻最大值, 周期
+	uint32_t LowMax[2];  // 低电平宽度最大值, 周期. 0:写0时隙 | 1:写1/读时隙
+	uint32_t Late;       // 时序越限的时隙数(采样不早于15us, 写1/读低电平不短于15us或写0低电平不短于120us)
+} OneWire_StatTypeDef;
+
+extern OneWire_StatTypeDef OneWire_Stat;
+#endif
+
+void OneWire_Init(void);
+uint8_t OneWire_Reset(void);
+void OneWire_WriteBit(uint8_t Bit);
+uint8_t OneWire_ReadBit(void);
+void OneWire_WriteByte(uint8_t Data);
+uint8_t OneWire_ReadByte(void);
+uint8_t OneWire_Touch(uint8_t *Data, uint8_t Len);
+void OneWire_TouchStart(uint8_t *Data, uint8_t Len);
+uint8_t OneWire_TouchDone(void);
+uint8_t OneWire_TouchEnd(void);
+
+#endif
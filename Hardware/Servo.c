@@ -6,7 +6,14 @@ void Servo_Init(void)
 	PWM_Init();
 }
 
-void Servo_SetAngle(float Angle)
+/**
+ * @brief  设置舵机角度: 0 - 180°对应脉宽500 - 2500us(TIM2计数1us)
+ * @param  Angle 角度, 0 - 180
+ * @retval 无
+ */
+void Servo_SetAngle(uint8_t Angle)
 {
-	PWM_SetCompare2(Angle / 180 * 2000 + 500);
+	if (Angle > 180)
+		Angle = 180;
+	PWM_SetCompare2(500 + Angle * 100 / 9); // 2000 / 180 = 100 / 9
 }
@@ -2,6 +2,6 @@
 #define __SERVO_H
 
 void Servo_Init(void);
-void Servo_SetAngle(float Angle);
+void Servo_SetAngle(uint8_t Angle);
 
 #endif
@@ -1,33 +1,279 @@
 #include "stm32f10x.h" // Device header
 #include "MyUSART.h"
-#include <stdio.h>
 #include <string.h>
 #include "Delay.h"
+#include "Fmt.h"
+#include "Calendar.h"
+#include "Tick.h"
+#include "esp.h"
 
-extern char RECS[250];
 extern char Feed_ED;
 extern uint8_t FeedInterval[3];
 
 const char *WIFI = "vivo";
 const char *WIFIASSWORD = "12345678";
 
-int fputc(int ch, FILE *f) // printf重定向
+#define ESP_QUEUE_LEN 8 // AT命令队列长度
+
+typedef struct
+{
+    const char *Cmd;   // 命令字符串(含"\r\n"), 须在命令完成前保持有效
+    const char *Match; // 成功应答行前缀, NULL表示"OK"
+    uint16_t Timeout;  // 超时时间, 毫秒
+    Esp_Callback Done; // 完成回调, 可为NULL
+} Esp_CmdTypeDef;
+
+static Esp_CmdTypeDef Esp_Queue[ESP_QUEUE_LEN];
+static uint8_t Esp_QHead = 0, Esp_QTail = 0; // 队首(当前命令)、队尾下标
+
+static uint8_t Esp_State = ESP_STATE_IDLE; // 当前命令状态
+static uint8_t Esp_Result;                 // 当前命令结果
+static volatile uint32_t Esp_SendTick;     // 当前命令发出时刻, 毫秒
+
+static char Esp_WiFiCmd[64];     // 连接热点命令缓冲
+static char Esp_PubCmd[448];     // 上传数据命令缓冲
+static Esp_Callback Esp_PubDone; // 上传完成回调
+static uint8_t Esp_PubBusy = 0;  // 上传进行中标志
+static uint32_t Esp_SntpTime;    // 最近一次+CIPSNTPTIME应答的UTC秒数, 0表示模块尚未取得网络时间
+
+/**
+ * @brief  当前命令已全部发出, 从此刻开始计算应答超时(在DMA发送完成中断内调用)
+ * @param  无
+ * @retval 无
+ */
+static void Esp_TxDone(void)
+{
+    Esp_SendTick = Tick_Get();
+}
+
+/**
+ * @brief  AT命令入队, 立即返回。命令按入队顺序逐条发送, 收到终止应答或超时后发送下一条
+ * @param  Cmd 命令字符串(含"\r\n"), 须在命令完成前保持有效
+ * @param  Match 成功应答行前缀, NULL表示以"OK"为成功应答
+ * @param  Timeout 超时时间, 毫秒
+ * @param  Done 完成回调(在Esp_Poll中调用), 参数为ESP_OK/ESP_ERROR/ESP_TIMEOUT, 可为NULL
+ * @retval 1:队列已满 | 0:入队成功
+ */
+uint8_t Esp_Send(const char *Cmd, const char *Match, uint16_t Timeout, Esp_Callback Done)
+{
+    uint8_t Next = (Esp_QTail + 1) % ESP_QUEUE_LEN;
+    if (Next == Esp_QHead)
+        return 1;
+    Esp_Queue[Esp_QTail].Cmd = Cmd;
+    Esp_Queue[Esp_QTail].Match = Match;
+    Esp_Queue[Esp_QTail].Timeout = Timeout;
+    Esp_Queue[Esp_QTail].Done = Done;
+    Esp_QTail = Next;
+    return 0;
+}
+
+/**
+ * @brief  查询AT命令引擎是否有未完成的命令
+ * @param  无
+ * @retval 1:有命令排队或等待应答 | 0:空闲
+ */
+uint8_t Esp_Busy(void)
+{
+    return Esp_QHead != Esp_QTail;
+}
+
+/**
+ * @brief  AT命令引擎调度, 在主循环中反复调用, 不阻塞.
+ *         处理串口收到的各行、完成命令的回调、检查当前命令超时、发送队列中的下一条命令
+ * @param  无
+ * @retval 无
+ */
+void Esp_Poll(void)
 {
-    USART_SendData(USART1, (uint8_t)ch);
-    while (USART_GetFlagStatus(USART1, USART_FLAG_TC) == RESET)
+    Esp_CmdTypeDef *Cur;
+    char *Line;
+
+    while ((Line = MyUSART_GetLine()) != NULL)
+        Esp_RxLine(Line);
+
+    if (Esp_QHead == Esp_QTail)
+        return;
+    Cur = &Esp_Queue[Esp_QHead];
+
+    if ((Esp_State == ESP_STATE_WAIT) && (Tick_Get() - Esp_SendTick > Cur->Timeout))
+    {
+        Esp_Result = ESP_TIMEOUT;
+        Esp_State = ESP_STATE_DONE;
+    }
+
+    if (Esp_State == ESP_STATE_DONE)
+    {
+        Esp_QHead = (Esp_QHead + 1) % ESP_QUEUE_LEN;
+        Esp_State = ESP_STATE_IDLE;
+        if (Cur->Done)
+            Cur->Done(Esp_Result);
+        return;
+    }
+
+    if (Esp_State == ESP_STATE_IDLE)
+    {
+        Esp_SendTick = Tick_Get();
+        Esp_State = ESP_STATE_WAIT;
+        if (MyUSART_Write((const uint8_t *)Cur->Cmd, strlen(Cur->Cmd), Esp_TxDone))
+            Esp_State = ESP_STATE_IDLE; // 发送回调队列满, 下次调用再发送
+    }
+}
+
+/**
+ * @brief  丢弃队列中尚未发送的命令(当前等待应答的命令不受影响)
+ * @param  无
+ * @retval 无
+ */
+void Esp_Flush(void)
+{
+    if (Esp_QHead == Esp_QTail)
+        return;
+    if (Esp_State == ESP_STATE_IDLE)
+        Esp_QTail = Esp_QHead;
+    else
+        Esp_QTail = (Esp_QHead + 1) % ESP_QUEUE_LEN;
+}
+
+/**
+ * @brief  读取下一个十进制数, 跳过数字前的非数字字符
+ * @param  P 读取位置, 返回时指向数字之后
+ * @retval 数值, 无数字时为0
+ */
+static uint16_t Esp_Num(const char **P)
+{
+    uint16_t v = 0;
+
+    while (**P && ((**P < '0') || (**P > '9')))
+        (*P)++;
+    while ((**P >= '0') && (**P <= '9'))
+        v = v * 10 + (*(*P)++ - '0');
+    return v;
+}
+
+/**
+ * @brief  解析+CIPSNTPTIME应答中的时间, 如"Thu Aug 04 14:48:05 2016"(时区为0, 即UTC)
+ * @param  Text 应答中冒号之后的部分
+ * @retval UTC秒数, 格式错误或模块尚未同步(年份早于ESP_SNTP_YEAR_MIN)时为0
+ */
+static uint32_t Esp_ParseTime(const char *Text)
+{
+    static const char Month[] = "JanFebMarAprMayJunJulAugSepOctNovDec";
+    Calendar_TypeDef T;
+    uint8_t i;
+
+    if (strlen(Text) < 24)
+        return 0;
+    Text += 4; // 星期
+    for (i = 0; (i < 12) && strncmp(Text, Month + i * 3, 3); i++)
         ;
-    return ch;
+    if (i == 12)
+        return 0;
+    Text += 3;
+    T.Month = i + 1;
+    T.Day = Esp_Num(&Text);
+    T.Hour = Esp_Num(&Text);
+    T.Minute = Esp_Num(&Text);
+    T.Second = Esp_Num(&Text);
+    T.Year = Esp_Num(&Text);
+    if ((T.Year < ESP_SNTP_YEAR_MIN) || (T.Day < 1) || (T.Day > 31) || (T.Hour > 23) || (T.Minute > 59) || (T.Second > 59))
+        return 0;
+    return Calendar_ToSeconds(&T);
 }
 
 /**
- * @brief  ESP8266初始化
+ * @brief  查询模块的网络时间(AT+CIPSNTPTIME?), 命令入队后立即返回, 结果由Esp_GetSntpTime读取
+ * @param  Done 完成回调, 参数为ESP_OK/ESP_ERROR/ESP_TIMEOUT, 可为NULL
+ * @retval 1:队列已满 | 0:已入队
+ */
+uint8_t Esp_SNTP(Esp_Callback Done)
+{
+    Esp_SntpTime = 0;
+    return Esp_Send("AT+CIPSNTPTIME?\r\n", NULL, 2000, Done);
+}
+
+/**
+ * @brief  读取最近一次Esp_SNTP查询到的网络时间, 在其完成回调中调用
+ * @param  无
+ * @retval UTC秒数, 0表示模块尚未取得网络时间或应答无法解析
+ */
+uint32_t Esp_GetSntpTime(void)
+{
+    return Esp_SntpTime;
+}
+
+/**
+ * @brief  处理ESP8266发来的一行数据(不含"\r\n"), 由Esp_Poll调用.
+ *         平台下发消息交由CommandAnalyse解析; 其余行与当前命令的终止应答比对
+ * @param  Line 一行数据
+ * @retval 无
+ */
+void Esp_RxLine(char *Line)
+{
+    const char *Match;
+
+    if (strncmp(Line, "+MQTTSUBRECV:0", 14) == 0)
+    {
+        CommandAnalyse(Line);
+        return;
+    }
+
+    if (strncmp(Line, "+CIPSNTPTIME:", 13) == 0)
+    {
+        Esp_SntpTime = Esp_ParseTime(Line + 13);
+        return;
+    }
+
+    if (Esp_State != ESP_STATE_WAIT)
+        return;
+
+    Match = Esp_Queue[Esp_QHead].Match;
+    if (Match == NULL)
+        Match = "OK";
+    if (strncmp(Line, Match, strlen(Match)) == 0)
+    {
+        Esp_Result = ESP_OK;
+        Esp_State = ESP_STATE_DONE;
+    }
+    else if ((strcmp(Line, "ERROR") == 0) || (strcmp(Line, "FAIL") == 0))
+    {
+        Esp_Result = ESP_ERROR;
+        Esp_State = ESP_STATE_DONE;
+    }
+}
+
+static uint8_t Esp_ExecResult;
+
+static void Esp_ExecDone(uint8_t Result)
+{
+    Esp_ExecResult = Result;
+}
+
+/**
+ * @brief  发送一条AT命令并等待其完成(收到终止应答即返回, 不做固定延时)
+ * @param  Cmd 命令字符串(含"\r\n")
+ * @param  Match 成功应答行前缀, NULL表示"OK"
+ * @param  Timeout 超时时间, 毫秒
+ * @retval ESP_OK/ESP_ERROR/ESP_TIMEOUT
+ */
+static uint8_t Esp_Exec(const char *Cmd, const char *Match, uint16_t Timeout)
+{
+    Esp_ExecResult = ESP_TIMEOUT;
+    if (Esp_Send(Cmd, Match, Timeout, Esp_ExecDone))
+        return ESP_ERROR;
+    while (Esp_Busy())
+        Esp_Poll();
+    return Esp_ExecResult;
+}
+
+/**
+ * @brief  ESP8266初始化, 逐条发送配网命令, 每条命令收到应答后立即发送下一条
  * @param  无
  * @retval 错误码
  * 0:初始化成功 |
  * 1:关闭回显失败 |
  * 2:切换混合模式失败 |
  * 3:联网失败 |
- * 4:时区校准失败 |
+ * 4:配置SNTP失败 |
  * 5:上传用户配置信息失败 |
  * 6:上传MQTT标识符失败 |
  * 7:连接MQTT Broker失败 |
@@ -35,129 +281,248 @@ int fputc(int ch, FILE *f) // printf重定向
  */
 uint8_t esp_Init(void)
 {
-    memset(RECS, 0, sizeof(RECS));
-    printf("AT+RST\r\n"); // 重启
-    Delay_ms(2000);
+    Fmt_TypeDef F;
 
-    memset(RECS, 0, sizeof(RECS));
-    printf("ATE0\r\n"); // 关闭回显
-    Delay_ms(10);
-    if (strcmp(RECS, "OK"))
+    Esp_Exec("AT+RST\r\n", "ready", 5000); // 重启, 等待模块就绪
+
+    if (Esp_Exec("ATE0\r\n", NULL, 2000)) // 关闭回显
         return 1;
 
-    printf("AT+CWMODE=3\r\n"); // 混合模式
-    Delay_ms(500);
-    if (strcmp(RECS, "OK"))
+    if (Esp_Exec("AT+CWMODE=3\r\n", NULL, 2000)) // 混合模式
         return 2;
 
-    memset(RECS, 0, sizeof(RECS));
-    printf("AT+CWJAP=\"%s\",\"%s\"\r\n", WIFI, WIFIASSWORD); // 连接热点
-    Delay_ms(2000);
-    if (strcmp(RECS, "OK"))
+    Fmt_Init(&F, Esp_WiFiCmd, sizeof(Esp_WiFiCmd), NULL); // 连接热点, 名称与密码中的特殊字符须转义
+    Fmt_Str(&F, "AT+CWJAP=\"");
+    Fmt_Esc(&F, WIFI);
+    Fmt_Str(&F, "\",\"");
+    Fmt_Esc(&F, WIFIASSWORD);
+    Fmt_Str(&F, "\"\r\n");
+    if (Fmt_End(&F) || Esp_Exec(Esp_WiFiCmd, NULL, 20000))
         return 3;
 
-    memset(RECS, 0, sizeof(RECS));
-    printf("AT+CIPSNTPCFG=1,8,\"ntp1.aliyun.com\"\r\n"); // 校准时区
-    Delay_ms(200);
-    if (strcmp(RECS, "OK"))
+    if (Esp_Exec("AT+CIPSNTPCFG=1,0,\"ntp1.aliyun.com\"\r\n", NULL, 2000)) // 启用SNTP, 时区0: 查询结果为UTC, 本地时间由RTC模块换算
         return 4;
 
-    memset(RECS, 0, sizeof(RECS)); // 用户信息配置
-    printf("AT+MQTTUSERCFG=0,1,\"NULL\",\"tyma110&a1IZ6nPksSi\",\"BA2ECBA29B0FDD0C4E244399920A5551D24E0D55\",0,0,\"\"\r\n");
-    Delay_ms(1000);
-    if (strcmp(RECS, "OK"))
+    // 用户信息配置
+    if (Esp_Exec("AT+MQTTUSERCFG=0,1,\"NULL\",\"tyma110&a1IZ6nPksSi\",\"BA2ECBA29B0FDD0C4E244399920A5551D24E0D55\",0,0,\"\"\r\n", NULL, 2000))
         return 5;
 
-    memset(RECS, 0, sizeof(RECS)); // 上传MQTT标识符
-    printf("AT+MQTTCLIENTID=0,\"1234|securemode=3\\,signmethod=hmacsha1|\"\r\n");
-    Delay_ms(200);
-    if (strcmp(RECS, "OK"))
+    // 上传MQTT标识符
+    if (Esp_Exec("AT+MQTTCLIENTID=0,\"1234|securemode=3\\,signmethod=hmacsha1|\"\r\n", NULL, 2000))
         return 6;
 
-    memset(RECS, 0, sizeof(RECS)); // 连接 MQTT Broker
-    printf("AT+MQTTCONN=0,\"a1IZ6nPksSi.iot-as-mqtt.cn-shanghai.aliyuncs.com\",1883,1\r\n+MQTTCONNECTED:0,1,\"a1IZ6nPksSi.iot-as-mqtt.cn-shanghai.aliyuncs.com\",\"1883\",\"\",1\r\n");
-    Delay_ms(1500);
-    if (strcmp(RECS, "OK"))
+    // 连接 MQTT Broker
+    if (Esp_Exec("AT+MQTTCONN=0,\"a1IZ6nPksSi.iot-as-mqtt.cn-shanghai.aliyuncs.com\",1883,1\r\n", NULL, 10000))
         return 7;
 
-    printf("AT+MQTTSUB=0,\"/sys/a1IZ6nPksSi/tyma110/thing/service/property/set\",1\r\n"); // 订阅消息
-    Delay_ms(1000);
-    if (strcmp(RECS, "OK"))
+    // 订阅消息
+    if (Esp_Exec("AT+MQTTSUB=0,\"/sys/a1IZ6nPksSi/tyma110/thing/service/property/set\",1\r\n", NULL, 5000))
         return 8;
-    memset(RECS, 0, sizeof(RECS));
     return 0;
 }
 
+static void Esp_PubFinish(uint8_t Result)
+{
+    Esp_PubBusy = 0;
+    if (Esp_PubDone)
+        Esp_PubDone(Result);
+}
+
 /**
- * @brief  经ESP上传数据
+ * @brief  经ESP上传数据, 命令入队后立即返回, 结果经回调通知
  * @param  Feedtimes 投饵计次
- * @param  Temperature 温度
+ * @param  Temperature 各传感器温度, 单位0.01℃, 以两位小数上传; 0号传感器上传为"Temperature", i号为"Temperature<i+1>"
+ * @param  Valid 各传感器读数有效标志, 第i位对应i号传感器, 无效的读数不上传
  * @param  F_ED 自动投饵开关. '1':启用 | '0':禁用
  * @param  FeedInterval 投饵间隔
- * @retval 发送状态. 1:发送失败 | 0:发送成功
+ * @param  Stat 温度传感器总线错误统计, 上传为"SensorCrcErr"(校验失败)、"SensorNoResp"(无应答)、"SensorRetry"(重试)
+ * @param  UtcOffset UTC偏移, 分钟, 上传为"UtcOffset"
+ * @param  Done 上传完成回调, 参数为ESP_OK/ESP_ERROR/ESP_TIMEOUT, 可为NULL
+ * @retval 1:上一次上传尚未完成或命令超出缓冲区, 本次未发送 | 0:已入队
  */
-uint8_t Esp_PUB(uint16_t Feedtimes, uint8_t Temperature, uint8_t F_ED, uint8_t *FeedInterval)
+uint8_t Esp_PUB(uint16_t Feedtimes, const int16_t *Temperature, uint8_t Valid, uint8_t F_ED, uint8_t *FeedInterval, const DS18B20_StatTypeDef *Stat, int16_t UtcOffset, Esp_Callback Done)
 {
+    Fmt_TypeDef F;
+    uint8_t i;
+
+    if (Esp_PubBusy)
+        return 1;
     if (F_ED == '1')
         F_ED = 1;
     if (F_ED == '0')
         F_ED = 0;
-    memset(RECS, 0, sizeof(RECS));
-    printf("AT+MQTTPUB=0,\"/sys/a1IZ6nPksSi/tyma110/thing/event/property/post\",\"{\\\"method\\\":\\\"thing.event.property.post\\\"\\,\\\"params\\\":{\\\"Feedtimes\\\":%d\\,\\\"Temperature\\\":%d\\,\\\"Feed_ED\\\":%d\\,\\\"FeedInterval_h\\\":%d\\,\\\"FeedInterval_m\\\":%d\\,\\\"FeedInterval_s\\\":%d}}\",0,0\r\n", Feedtimes, Temperature, F_ED, FeedInterval[0], FeedInterval[1], FeedInterval[2]);
-    Delay_ms(1000); // 延时等待数据接收完成
-    if (strcmp(RECS, "ERROR") == 0)
+    // 消息体JSON是AT命令的字符串参数, 其中的'"'与','在常量中已转义, 无需逐字符检查
+    Fmt_Init(&F, Esp_PubCmd, sizeof(Esp_PubCmd), NULL);
+    Fmt_Str(&F, "AT+MQTTPUB=0,\"/sys/a1IZ6nPksSi/tyma110/thing/event/property/post\",\"{\\\"method\\\":\\\"thing.event.property.post\\\"\\,\\\"params\\\":{\\\"Feedtimes\\\":");
+    Fmt_Uint(&F, Feedtimes, 1);
+    for (i = 0; i < DS18B20_MAX; i++)
+    {
+        if (!(Valid & (1 << i)))
+            continue;
+        Fmt_Str(&F, "\\,\\\"Temperature");
+        if (i > 0)
+            Fmt_Uint(&F, i + 1, 1);
+        Fmt_Str(&F, "\\\":");
+        Fmt_Fixed(&F, Temperature[i], 2);
+    }
+    Fmt_Str(&F, "\\,\\\"Feed_ED\\\":");
+    Fmt_Uint(&F, F_ED, 1);
+    Fmt_Str(&F, "\\,\\\"FeedInterval_h\\\":");
+    Fmt_Uint(&F, FeedInterval[0], 1);
+    Fmt_Str(&F, "\\,\\\"FeedInterval_m\\\":");
+    Fmt_Uint(&F, FeedInterval[1], 1);
+    Fmt_Str(&F, "\\,\\\"FeedInterval_s\\\":");
+    Fmt_Uint(&F, FeedInterval[2], 1);
+    Fmt_Str(&F, "\\,\\\"SensorCrcErr\\\":");
+    Fmt_Uint(&F, Stat->Crc, 1);
+    Fmt_Str(&F, "\\,\\\"SensorNoResp\\\":");
+    Fmt_Uint(&F, Stat->Presence, 1);
+    Fmt_Str(&F, "\\,\\\"SensorRetry\\\":");
+    Fmt_Uint(&F, Stat->Retry, 1);
+    Fmt_Str(&F, "\\,\\\"UtcOffset\\\":");
+    Fmt_Int(&F, UtcOffset);
+    Fmt_Str(&F, "}}\",0,0\r\n");
+    if (Fmt_End(&F))
+        return 1;
+    Esp_PubDone = Done;
+    if (Esp_Send(Esp_PubCmd, NULL, 5000, Esp_PubFinish))
         return 1;
+    Esp_PubBusy = 1;
     return 0;
 }
 
 /**
- * @brief  平台回传信息解析
- * @param  无
- * @retval ESPparam 数组 [0]:投饵间隔 | [1]:自动投饵开关状态
+ * @brief  在平台下发的JSON中查找"Key":
+ * @param  Json 消息字符串
+ * @param  Key 属性名
+ * @retval 取值的起始位置, NULL表示未找到
+ */
+static const char *Esp_FindKey(const char *Json, const char *Key)
+{
+    const char *P = Json;
+    size_t Len = strlen(Key);
+
+    while ((P = strstr(P, Key)) != NULL)
+    {
+        if ((P > Json) && (P[-1] == '"') && (P[Len] == '"') && (P[Len + 1] == ':'))
+            return P + Len + 2;
+        P += Len;
+    }
+    return NULL;
+}
+
+/**
+ * @brief  在平台下发的JSON中查找"Key":后的整数, 至多4位数字
+ * @param  Json 消息字符串
+ * @param  Key 属性名
+ * @param  Value 解析结果
+ * @param  Signed 1:允许负号 | 0:只接受非负整数
+ * @retval 1:找到 | 0:未找到或不是数字
  */
-void CommandAnalyse(void)
+static uint8_t Esp_ParseInt(const char *Json, const char *Key, int16_t *Value, uint8_t Signed)
 {
-    if (strncmp(RECS, "+MQTTSUBRECV:0", 14) == 0)
+    const char *P = Esp_FindKey(Json, Key);
+    uint8_t n = 0, Neg = 0;
+    int16_t v = 0;
+
+    if (P == NULL)
+        return 0;
+    if (Signed && (*P == '-'))
+    {
+        Neg = 1;
+        P++;
+    }
+    while ((*P >= '0') && (*P <= '9') && (n < 4))
+    {
+        v = v * 10 + (*P++ - '0');
+        n++;
+    }
+    if (n == 0)
+        return 0;
+    *Value = Neg ? -v : v;
+    return 1;
+}
+
+/**
+ * @brief  在平台下发的JSON中查找"Key":后的非负整数
+ * @param  Json 消息字符串
+ * @param  Key 属性名
+ * @param  Value 解析结果
+ * @retval 1:找到 | 0:未找到或不是数字
+ */
+static uint8_t Esp_GetInt(const char *Json, const char *Key, uint16_t *Value)
+{
+    int16_t v;
+
+    if (!Esp_ParseInt(Json, Key, &v, 0))
+        return 0;
+    *Value = v;
+    return 1;
+}
+
+static uint8_t Esp_Changed = 0; // 平台下发后发生变化的属性, ESP_CHANGED_*按位或
+static int16_t Esp_UtcOffset;   // 平台下发的UTC偏移, 分钟
+
+/**
+ * @brief  平台回传信息解析, 更新自动投饵开关与投饵间隔, 取得UTC偏移("UtcOffset", 分钟).
+ *         越界的取值被忽略; 取值有变化时记入Esp_Changed, 由Esp_GetChanged取走;
+ *         UTC偏移由调用者以Esp_GetUtcOffset取得后与当前值比较
+ * @param  RECS 平台下发的一行消息("+MQTTSUBRECV:0,...")
+ * @retval 无
+ */
+void CommandAnalyse(char *RECS)
+{
+    static const char *Key[3] = {"FeedInterval_h", "FeedInterval_m", "FeedInterval_s"};
+    static const uint8_t Max[3] = {23, 59, 59};
+    uint8_t i, New[3];
+    uint16_t Value;
+    int16_t Offset;
+
+    if (strncmp(RECS, "+MQTTSUBRECV:0", 14) != 0)
+        return;
+
+    if (Esp_GetInt(RECS, "Feed_ED", &Value) && (Value <= 1) && (Feed_ED != '0' + Value))
     {
-        uint8_t i = 0;
-        uint8_t FIh[2], FIm[2], FIs[2];
-        uint8_t j = 0;
-        while (RECS[i++] != '\0')
-        {
-            if (strncmp((RECS + i), "Feed_ED", 7) == 0)
-            {
-                while (RECS[i++] != ':')
-                    ;
-                Feed_ED = RECS[i];
-            }
-
-            if (strncmp((RECS + i), "FeedInterval_h", 14) == 0)
-            {
-                while (RECS[i++] != ':')
-                    ;
-                do
-                {
-                    FIh[j++] = RECS[i];
-                } while (RECS[i++] != '}');
-            }
-
-            if (strncmp((RECS + i), "FeedInterval_m", 14) == 0)
-            {
-                while (RECS[i++] != ':')
-                    do
-                    {
-                        FIm[j++] = RECS[i];
-                    } while (RECS[i++] != '}');
-            }
-
-            if (strncmp((RECS + i), "FeedInterval_s", 14) == 0)
-            {
-                while (RECS[i++] != ':')
-                    do
-                    {
-                        FIs[j++] = RECS[i];
-                    } while (RECS[i++] != '}');
-            }
-        }
+        Feed_ED = '0' + Value;
+        Esp_Changed |= ESP_CHANGED_FEED_ED;
     }
+
+    memcpy(New, FeedInterval, 3);
+    for (i = 0; i < 3; i++)
+        if (Esp_GetInt(RECS, Key[i], &Value) && (Value <= Max[i]))
+            New[i] = Value;
+    // 间隔不能为0
+    if ((New[0] || New[1] || New[2]) && memcmp(New, FeedInterval, 3))
+    {
+        memcpy(FeedInterval, New, 3);
+        Esp_Changed |= ESP_CHANGED_INTERVAL;
+    }
+
+    if (Esp_ParseInt(RECS, "UtcOffset", &Offset, 1) && (Offset >= -720) && (Offset <= 840))
+    {
+        Esp_UtcOffset = Offset;
+        Esp_Changed |= ESP_CHANGED_OFFSET;
+    }
+}
+
+/**
+ * @brief  获取平台最近一次下发的UTC偏移, Esp_GetChanged含ESP_CHANGED_OFFSET时有效
+ * @param  无
+ * @retval UTC偏移, 分钟
+ */
+int16_t Esp_GetUtcOffset(void)
+{
+    return Esp_UtcOffset;
+}
+
+/**
+ * @brief  获取并清除平台下发后发生变化的属性
+ * @param  无
+ * @retval ESP_CHANGED_*按位或, 0表示无变化
+ */
+uint8_t Esp_GetChanged(void)
+{
+    uint8_t Changed = Esp_Changed;
+    Esp_Changed = 0;
+    return Changed;
 }
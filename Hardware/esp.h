@@ -1,8 +1,39 @@
 #ifndef __esp_H
 #define __esp_H
 
+#include "DS18B20.h"
+
+// AT命令结果
+#define ESP_OK 0      // 收到成功应答
+#define ESP_ERROR 1   // 收到"ERROR"/"FAIL"
+#define ESP_TIMEOUT 2 // 超时未收到终止应答
+
+// AT命令引擎状态
+#define ESP_STATE_IDLE 0 // 无命令在途
+#define ESP_STATE_WAIT 1 // 已发送, 等待终止应答
+#define ESP_STATE_DONE 2 // 已完成, 等待回调
+
+// 平台下发后发生变化的属性
+#define ESP_CHANGED_FEED_ED 0x01  // 自动投饵开关
+#define ESP_CHANGED_INTERVAL 0x02 // 投饵间隔
+#define ESP_CHANGED_OFFSET 0x04   // 平台下发了UTC偏移(可能与当前值相同)
+
+#define ESP_SNTP_YEAR_MIN 2024 // 网络时间早于此年份视为模块尚未同步(未同步时应答1970年)
+
+typedef void (*Esp_Callback)(uint8_t Result);
+
+uint8_t Esp_Send(const char *Cmd, const char *Match, uint16_t Timeout, Esp_Callback Done);
+uint8_t Esp_Busy(void);
+void Esp_Poll(void);
+void Esp_Flush(void);
+void Esp_RxLine(char *Line);
+
 uint8_t esp_Init(void);
-uint8_t Esp_PUB(uint16_t Feedtimes, uint8_t Temperature, uint8_t F_ED, uint8_t *FeedInterval);
-uint16_t *CommandAnalyse(void);
+uint8_t Esp_PUB(uint16_t Feedtimes, const int16_t *Temperature, uint8_t Valid, uint8_t F_ED, uint8_t *FeedInterval, const DS18B20_StatTypeDef *Stat, int16_t UtcOffset, Esp_Callback Done);
+uint8_t Esp_SNTP(Esp_Callback Done);
+uint32_t Esp_GetSntpTime(void);
+void CommandAnalyse(char *RECS);
+uint8_t Esp_GetChanged(void);
+int16_t Esp_GetUtcOffset(void);
 
 #endif
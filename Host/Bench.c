@@ -0,0 +1,110 @@
+#include "stm32f10x.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "OLED.h"
+#include "MyRTC.h"
+#include "UI.h"
+#include "esp.h"
+#include "SSD1306.h"
+#include "Sim.h"
+
+/*
+ * 热点函数基准测试(主机速度, 只用于比较改动前后的相对变化).
+ * 每项重复执行若干次, 报告平均每次耗时; 界面项同时报告每帧OLED总线流量与400kHz下的传输时间.
+ */
+
+extern uint8_t FeedInterval[3];
+extern Calendar_TypeDef TempT;
+extern uint8_t *TempFI;
+extern const UI_Screen UI_MainScreen, UI_SetScreen;
+
+static double Bench_Now(void)
+{
+    struct timespec Ts;
+    clock_gettime(CLOCK_MONOTONIC, &Ts);
+    return Ts.tv_sec * 1e9 + Ts.tv_nsec;
+}
+
+static void Bench_Report(const char *Name, uint32_t Count, double Start)
+{
+    printf("%-28s %10u calls %10.1f ns/call\n", Name, (unsigned)Count, (Bench_Now() - Start) / Count);
+}
+
+// 每帧绘制的字符数与OLED总线流量
+static void Bench_Frame(uint32_t N)
+{
+    SSD1306_Stats Stats;
+
+    SSD1306_GetStats(&Stats);
+    printf("%-28s %10.1f glyphs/frame %6.1f bytes/frame %6.1f transfers/frame %8.1f us bus/frame\n", "",
+           (double)UI_Glyphs / N, (double)Stats.Bytes / N, (double)Stats.Trans / N, Stats.BusNs / 1000.0 / N);
+}
+
+int Bench_Run(void)
+{
+    static char Line[320];
+    uint8_t Interval[3] = {1, 30, 0};
+    uint32_t i;
+    const uint32_t N = 200000;
+    double Start;
+
+    MyRTC_Init();
+    OLED_Init();
+    memcpy(FeedInterval, Interval, 3);
+    MyRTC_GetTime(&TempT);
+    TempFI = Interval;
+
+    // 界面不变时的更新: 只读取绑定值并比较
+    UI_Show(&UI_MainScreen);
+    UI_Update();
+    Start = Bench_Now();
+    for (i = 0; i < N; i++)
+        UI_Update();
+    Bench_Report("UI_Update main (no change)", N, Start);
+
+    UI_Show(&UI_SetScreen);
+    UI_Update();
+    Start = Bench_Now();
+    for (i = 0; i < N; i++)
+        UI_Update();
+    Bench_Report("UI_Update set (no change)", N, Start);
+
+    // 主界面与设置界面交替, 每次切换清屏后重绘整个界面并刷新
+    SSD1306_ClearStats();
+    UI_Glyphs = 0;
+    Start = Bench_Now();
+    for (i = 0; i < N; i++)
+    {
+        UI_Show((i & 1) ? &UI_SetScreen : &UI_MainScreen);
+        UI_Update();
+        OLED_Refresh();
+    }
+    Bench_Report("page switch + OLED_Refresh", N, Start);
+    Bench_Frame(N);
+
+    // 主界面每秒只有时间变化
+    UI_Show(&UI_MainScreen);
+    UI_Update();
+    OLED_Refresh();
+    SSD1306_ClearStats();
+    UI_Glyphs = 0;
+    Start = Bench_Now();
+    for (i = 0; i < N; i++)
+    {
+        Sim_RTC_SetCounter(1704082245 + i);
+        UI_Update();
+        OLED_Refresh();
+    }
+    Bench_Report("clock tick + OLED_Refresh", N, Start);
+    Bench_Frame(N);
+
+    snprintf(Line, sizeof(Line), "+MQTTSUBRECV:0,\"/sys/a1IZ6nPksSi/tyma110/thing/service/property/set\",98,"
+                                 "{\"method\":\"thing.service.property.set\",\"id\":\"1\",\"params\":{\"Feed_ED\":1},\"version\":\"1.0.0\"}");
+    Start = Bench_Now();
+    for (i = 0; i < N; i++)
+        CommandAnalyse(Line);
+    Bench_Report("CommandAnalyse", N, Start);
+
+    return 0;
+}
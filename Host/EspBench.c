@@ -0,0 +1,139 @@
+#include "stm32f10x.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "MyUSART.h"
+#include "Fmt.h"
+#include "esp.h"
+#include "Sim.h"
+
+/*
+ * ESP8266链路基准测试, 配合Host/EspSim.c(或真实模块)使用:
+ *   1. 配网耗时: esp_Init()从AT+RST到订阅成功
+ *   2. 上传往返: 逐条Esp_PUB, 从入队到收到应答(回调)的时间分布
+ *   3. 接收压力: 请求仿真器以给定速率推送+MQTTSUBRECV, 统计收到、缺失与乱序条数
+ */
+
+static uint8_t Bench_PubDone;   // 上传完成标志
+static uint8_t Bench_PubResult; // 上传结果
+
+static double Bench_Ms(void)
+{
+    struct timespec Ts;
+    clock_gettime(CLOCK_MONOTONIC, &Ts);
+    return Ts.tv_sec * 1e3 + Ts.tv_nsec / 1e6;
+}
+
+static int Bench_Cmp(const void *A, const void *B)
+{
+    double X = *(const double *)A, Y = *(const double *)B;
+    return (X > Y) - (X < Y);
+}
+
+static void Bench_Done(uint8_t Result)
+{
+    Bench_PubResult = Result;
+    Bench_PubDone = 1;
+}
+
+/**
+ * @brief  打印一组时间的分布
+ * @param  Name 名称
+ * @param  Ms 时间数组(会被排序), 毫秒
+ * @param  N 个数
+ * @retval 无
+ */
+void EspBench_Report(const char *Name, double *Ms, uint32_t N)
+{
+    if (N == 0)
+    {
+        printf("%-16s no samples\n", Name);
+        return;
+    }
+    qsort(Ms, N, sizeof(double), Bench_Cmp);
+    printf("%-16s n=%-5u min %7.2f  p50 %7.2f  p99 %7.2f  max %7.2f ms\n", Name, (unsigned)N,
+           Ms[0], Ms[N / 2], Ms[(N * 99) / 100 < N ? (N * 99) / 100 : N - 1], Ms[N - 1]);
+}
+
+/**
+ * @brief  运行ESP8266链路基准测试
+ * @param  Pubs 上传次数
+ * @param  Pushes 推送条数
+ * @param  PushHz 推送速率, 条/秒
+ * @retval 0:成功 | 1:配网失败
+ */
+int EspBench_Run(uint32_t Pubs, uint32_t Pushes, uint32_t PushHz)
+{
+    char Cmd[16];
+    Fmt_TypeDef F;
+    uint8_t Interval[3] = {1, 30, 0};
+    int16_t Temperature[2] = {2500, 2150};
+    uint32_t i, Fail[3] = {0}, Got = 0, Missing = 0, Disorder = 0, Next = 0, Id;
+    double Start, Last, *Rtt;
+    char *Line, *P;
+    uint8_t Result;
+
+    // 配网
+    Start = Bench_Ms();
+    Result = esp_Init();
+    printf("%-16s %.1f ms (esp_Init=%u)\n", "boot-to-online", Bench_Ms() - Start, Result);
+    if (Result)
+        return 1;
+
+    // 上传往返
+    Rtt = malloc(sizeof(double) * (Pubs ? Pubs : 1));
+    for (i = 0; i < Pubs; i++)
+    {
+        Bench_PubDone = 0;
+        Start = Bench_Ms();
+        if (Esp_PUB(i, Temperature, 0x03, '1', Interval, &DS18B20_Stat, 480, Bench_Done))
+            break;
+        while (!Bench_PubDone)
+            Esp_Poll();
+        Fail[Bench_PubResult]++;
+        Rtt[i] = Bench_Ms() - Start;
+    }
+    EspBench_Report("publish RTT", Rtt, i);
+    printf("%-16s ok %u, error %u, timeout %u\n", "", Fail[ESP_OK], Fail[ESP_ERROR], Fail[ESP_TIMEOUT]);
+    free(Rtt);
+
+    // 接收压力: 命令队列此时已空, 控制命令直接发送, 不经Esp_Poll(它会自行取走收到的行);
+    // 各行先在此统计, 再交给Esp_RxLine按正常路径处理
+    if (Pushes)
+    {
+        Fmt_Init(&F, Cmd, sizeof(Cmd), MyUSART_Put);
+        Fmt_Str(&F, "AT+SIMPUSH=");
+        Fmt_Uint(&F, Pushes, 1);
+        Fmt_Char(&F, ',');
+        Fmt_Uint(&F, PushHz, 1);
+        Fmt_Str(&F, "\r\n");
+        Fmt_End(&F);
+        Start = Last = Bench_Ms();
+        while ((Got < Pushes) && (Bench_Ms() - Last < 2000))
+        {
+            while ((Line = MyUSART_GetLine()) != NULL)
+            {
+                if ((strncmp(Line, "+MQTTSUBRECV:0", 14) == 0) && ((P = strstr(Line, "\"id\":\"")) != NULL))
+                {
+                    Id = strtoul(P + 6, NULL, 10);
+                    if (Id < Next)
+                        Disorder++;
+                    else
+                    {
+                        Missing += Id - Next;
+                        Next = Id + 1;
+                    }
+                    Got++;
+                    Last = Bench_Ms();
+                }
+                Esp_RxLine(Line);
+            }
+        }
+        Missing += Pushes - (Next > Pushes ? Pushes : Next);
+        printf("%-16s %u/%u received in %.1f ms (%.0f msg/s), %u missing, %u out of order, %u bytes lost\n",
+               "push stress", (unsigned)Got, (unsigned)Pushes, Last - Start, Got * 1000.0 / (Last - Start + 1e-9),
+               (unsigned)Missing, (unsigned)Disorder, (unsigned)MyUSART_RxLost);
+    }
+    return 0;
+}
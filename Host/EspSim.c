@@ -0,0 +1,552 @@
+/*
+ * ESP8266 AT固件仿真器(主机工具), 在伪终端上模拟本项目用到的AT命令:
+ *   AT+RST ATE0 AT+CWMODE AT+CWJAP AT+CIPSNTPCFG AT+CIPSNTPTIME? AT+MQTTUSERCFG AT+MQTTCLIENTID
+ *   AT+MQTTCONN AT+MQTTSUB AT+MQTTPUB
+ * 另有仿真器控制命令 AT+SIMPUSH=<条数>,<每秒条数>: 订阅后按给定速率推送+MQTTSUBRECV.
+ *
+ * 同时充当MQTT服务器: 设备上传到.../thing/event/property/post的数据在此解析,
+ * --set场景模拟平台逐条下发property/set翻转Feed_ED, 以设备上传数据中出现新取值为"命令生效",
+ * 统计下发到生效的时间分布与上传吞吐量, 场景结束后终止被测程序.
+ *
+ * 用法:
+ *   espsim [选项]                    打印伪终端路径后持续服务, 固件以 --esp <路径> 连接
+ *   espsim [选项] -- <命令> [参数]   启动命令(伪终端路径追加为最后一个参数), 命令退出后以其返回值退出
+ * 选项:
+ *   --delay <ms>    每条命令的应答延时(默认5)
+ *   --join <ms>     AT+CWJAP连接热点耗时(默认1000)
+ *   --conn <ms>     AT+MQTTCONN连接服务器耗时(默认200)
+ *   --boot <ms>     AT+RST后到"ready"的耗时(默认300)
+ *   --baud <bps>    按串口波特率限制输出速度, 0为不限(默认115200)
+ *   --drop <p>      每行输出被丢弃的概率(默认0)
+ *   --error <p>     命令以ERROR应答的概率(默认0, AT+RST除外)
+ *   --push <n>,<hz> 订阅成功后自动推送n条+MQTTSUBRECV
+ *   --set <n>,<hz>  订阅成功后以不高于hz的速率下发n条property/set(上一条生效或超时后才下发下一条)
+ *   --feed <s>      订阅成功后下发投饵间隔s秒, 使投饵动作与命令、上传交叠
+ *   --sntp <ms>     连接热点后到取得网络时间的耗时, 此前AT+CIPSNTPTIME?应答1970年(默认2000)
+ *   --ntp-offset <s> 网络时间相对本机时间的偏移, 用于观察设备校时(默认0)
+ *   --seed <n>      随机数种子
+ *   --verbose       在标准错误输出收发内容
+ */
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdarg.h>
+#include <string.h>
+#include <time.h>
+#include <poll.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <unistd.h>
+#include <termios.h>
+#include <signal.h>
+#include <sys/wait.h>
+
+#define OUT_MAX 1024   // 待发送行队列长度
+#define LINE_MAX 512   // 单行最大长度
+#define SUB_TOPIC "/sys/a1IZ6nPksSi/tyma110/thing/service/property/set"
+#define POST_TOPIC "/sys/a1IZ6nPksSi/tyma110/thing/event/property/post"
+#define SET_MAX 10000  // --set最多条数
+#define SET_TIMEOUT 10 // 下发后未生效的超时时间, 秒
+
+typedef struct
+{
+    uint64_t Due; // 发送时刻, 纳秒
+    char Text[LINE_MAX];
+    size_t Sent;  // 已写入字节数
+} Out_TypeDef;
+
+static Out_TypeDef Out[OUT_MAX];
+static uint32_t OutHead = 0, OutTail = 0;
+static uint64_t OutLast = 0;     // 队尾行的发送时刻, 保证按入队顺序发出
+static uint64_t LinkFree = 0;    // 串口发送方向空闲时刻(波特率限速)
+static uint64_t RxFree = 0;      // 串口接收方向空闲时刻: 设备一次写入的命令按波特率逐字节到达
+static uint64_t RxLag = 0;       // 当前命令的最后一字节比实际读到时晚到达的时间, 纳秒
+
+static int Master = -1;
+static uint32_t Delay = 5, JoinDelay = 1000, ConnDelay = 200, BootDelay = 300, Baud = 115200;
+static double DropP = 0, ErrorP = 0;
+static int Verbose = 0;
+
+static int Echo = 1, Joined = 0, Connected = 0, Subscribed = 0;
+static uint32_t SntpDelay = 2000;  // 连接热点后到取得网络时间的耗时, 毫秒
+static uint64_t JoinTime = 0;      // 连接热点时刻, 纳秒
+static int SntpZone = 0;           // AT+CIPSNTPCFG设置的时区, 小时
+static long NtpOffset = 0;         // 网络时间相对本机时间的偏移, 秒
+static uint32_t PushLeft = 0, PushSeq = 0, AutoPushN = 0, AutoPushHz = 0;
+static uint64_t PushPeriod = 0, PushNext = 0;
+
+static uint32_t StatCmds = 0, StatLines = 0, StatDropped = 0, StatErrors = 0, StatPushes = 0, StatPubs = 0;
+// property/set场景
+static uint32_t SetLeft = 0, SetN = 0, SetHz = 0, FeedEvery = 0, SetTimeouts = 0, SetDone = 0;
+static uint64_t SetPeriod = 0, SetNext = 0, SetT0 = 0;
+static int SetPending = 0, SetValue = 0, DevFeedED = 1;
+static double SetMs[SET_MAX];
+// property/post统计
+static uint32_t StatPosts = 0;
+static uint64_t PostBytes = 0, PostFirst = 0, PostLast = 0;
+
+static uint64_t Rand = 88172645463325252ull;
+
+static uint64_t Now(void)
+{
+    struct timespec Ts;
+    clock_gettime(CLOCK_MONOTONIC, &Ts);
+    return (uint64_t)Ts.tv_sec * 1000000000ull + Ts.tv_nsec;
+}
+
+static double Random(void)
+{
+    Rand ^= Rand << 13;
+    Rand ^= Rand >> 7;
+    Rand ^= Rand << 17;
+    return (Rand >> 11) * (1.0 / 9007199254740992.0);
+}
+
+/**
+ * @brief  DelayMs毫秒后发送一行(自动追加"\r\n"), 按--drop概率丢弃
+ */
+static void Emit(uint32_t DelayMs, const char *Format, ...)
+{
+    va_list Arg;
+    uint64_t Due = Now() + RxLag + (uint64_t)DelayMs * 1000000ull;
+    Out_TypeDef *O;
+
+    if (OutTail - OutHead >= OUT_MAX)
+    {
+        StatDropped++;
+        return;
+    }
+    if (Due < OutLast)
+        Due = OutLast;
+    OutLast = Due;
+    if ((DropP > 0) && (Random() < DropP))
+    {
+        StatDropped++;
+        return;
+    }
+
+    O = &Out[OutTail++ % OUT_MAX];
+    O->Due = Due;
+    O->Sent = 0;
+    va_start(Arg, Format);
+    vsnprintf(O->Text, LINE_MAX - 2, Format, Arg);
+    va_end(Arg);
+    strcat(O->Text, "\r\n");
+}
+
+static void Result(uint32_t DelayMs, int Ok)
+{
+    if (Ok && (ErrorP > 0) && (Random() < ErrorP))
+    {
+        StatErrors++;
+        Ok = 0;
+    }
+    Emit(DelayMs, "");
+    Emit(0, Ok ? "OK" : "ERROR");
+}
+
+/**
+ * @brief  向设备下发一条property/set消息
+ * @param  Params params对象内容
+ */
+static void Publish(const char *Params)
+{
+    char Json[256];
+
+    snprintf(Json, sizeof(Json),
+             "{\"method\":\"thing.service.property.set\",\"id\":\"%u\",\"params\":{%s},\"version\":\"1.0.0\"}",
+             PushSeq++, Params);
+    Emit(0, "+MQTTSUBRECV:0,\"%s\",%u,%s", SUB_TOPIC, (unsigned)strlen(Json), Json);
+}
+
+static void Push(void)
+{
+    Publish("\"Feed_ED\":1");
+    StatPushes++;
+}
+
+/**
+ * @brief  处理设备上传的属性: 统计吞吐量, 检查等待中的property/set是否已生效
+ * @param  Cmd AT+MQTTPUB命令(载荷中的引号与逗号带转义)
+ */
+static void Post(const char *Cmd)
+{
+    const char *P;
+    uint64_t T = Now() + RxLag;
+
+    if (StatPosts++ == 0)
+        PostFirst = T;
+    PostLast = T;
+    PostBytes += strlen(Cmd) + 2;
+
+    P = strstr(Cmd, "Feed_ED");
+    if (P == NULL)
+        return;
+    while (*P && ((*P < '0') || (*P > '9')))
+        P++;
+    DevFeedED = atoi(P);
+    if (SetPending && (DevFeedED == SetValue))
+    {
+        SetMs[SetDone++] = (T - SetT0) / 1e6;
+        SetPending = 0;
+    }
+}
+
+/**
+ * @brief  property/set场景: 上一条已生效(或超时)且到达下发时刻时, 下发一条翻转Feed_ED的命令
+ */
+static void SetStep(void)
+{
+    char Params[32];
+    uint64_t T = Now();
+
+    if (SetPending && (T - SetT0 > SET_TIMEOUT * 1000000000ull))
+    {
+        SetTimeouts++;
+        SetPending = 0;
+    }
+    if (!SetLeft || SetPending || !Subscribed || (T < SetNext))
+        return;
+    SetValue = !DevFeedED;
+    snprintf(Params, sizeof(Params), "\"Feed_ED\":%d", SetValue);
+    Publish(Params);
+    SetT0 = T;
+    SetPending = 1;
+    SetLeft--;
+    SetNext = T + SetPeriod;
+}
+
+static int Cmp(const void *A, const void *B)
+{
+    double X = *(const double *)A, Y = *(const double *)B;
+    return (X > Y) - (X < Y);
+}
+
+static void StartPush(uint32_t N, uint32_t Hz)
+{
+    PushLeft = N;
+    PushPeriod = Hz ? 1000000000ull / Hz : 0;
+    PushNext = Now();
+}
+
+static void Command(char *Cmd)
+{
+    uint32_t N, Hz;
+
+    StatCmds++;
+    if (Verbose)
+        fprintf(stderr, "espsim <- %s\n", Cmd);
+    if (Echo)
+        Emit(0, "%s", Cmd);
+
+    if (strcmp(Cmd, "AT") == 0)
+        Result(Delay, 1);
+    else if (strcmp(Cmd, "AT+RST") == 0)
+    {
+        Echo = 1;
+        Joined = Connected = Subscribed = 0;
+        PushLeft = 0;
+        Emit(Delay, "");
+        Emit(0, "OK");
+        Emit(BootDelay, " ets Jan  8 2013,rst cause:2, boot mode:(3,7)");
+        Emit(0, "");
+        Emit(0, "ready");
+    }
+    else if (strcmp(Cmd, "ATE0") == 0)
+    {
+        Echo = 0;
+        Result(Delay, 1);
+    }
+    else if (strcmp(Cmd, "ATE1") == 0)
+    {
+        Echo = 1;
+        Result(Delay, 1);
+    }
+    else if (strncmp(Cmd, "AT+CWMODE=", 10) == 0)
+        Result(Delay, 1);
+    else if (strncmp(Cmd, "AT+CWJAP=", 9) == 0)
+    {
+        Joined = 1;
+        JoinTime = Now() + (uint64_t)(Delay + JoinDelay) * 1000000ull;
+        Emit(Delay + JoinDelay / 2, "WIFI CONNECTED");
+        Emit(JoinDelay / 2, "WIFI GOT IP");
+        Result(0, 1);
+    }
+    else if (strncmp(Cmd, "AT+CIPSNTPCFG=", 14) == 0)
+    {
+        sscanf(Cmd + 14, "%*d,%d", &SntpZone);
+        Result(Delay, 1);
+    }
+    else if (strcmp(Cmd, "AT+CIPSNTPTIME?") == 0)
+    {
+        char Text[32];
+        time_t T = 0; // 尚未同步: 1970-01-01 00:00:00(另加时区)
+        struct tm Tm;
+
+        if (Joined && (Now() - JoinTime >= (uint64_t)SntpDelay * 1000000ull))
+            T = time(NULL) + NtpOffset;
+        T += SntpZone * 3600;
+        gmtime_r(&T, &Tm);
+        strftime(Text, sizeof(Text), "%a %b %d %H:%M:%S %Y", &Tm);
+        Emit(Delay, "+CIPSNTPTIME:%s", Text);
+        Result(0, 1);
+    }
+    else if ((strncmp(Cmd, "AT+MQTTUSERCFG=", 15) == 0) || (strncmp(Cmd, "AT+MQTTCLIENTID=", 16) == 0))
+        Result(Delay, 1);
+    else if (strncmp(Cmd, "AT+MQTTCONN=", 12) == 0)
+    {
+        if (Joined)
+        {
+            Connected = 1;
+            Emit(Delay + ConnDelay, "+MQTTCONNECTED:0,1,\"a1IZ6nPksSi.iot-as-mqtt.cn-shanghai.aliyuncs.com\",\"1883\",\"\",1");
+        }
+        Result(Joined ? 0 : Delay, Joined);
+    }
+    else if (strncmp(Cmd, "AT+MQTTSUB=", 11) == 0)
+    {
+        Subscribed = Connected;
+        Result(Delay, Connected);
+        if (Subscribed && AutoPushN)
+            StartPush(AutoPushN, AutoPushHz);
+        if (Subscribed && FeedEvery)
+        {
+            char Params[96];
+            snprintf(Params, sizeof(Params), "\"FeedInterval_h\":%u,\"FeedInterval_m\":%u,\"FeedInterval_s\":%u",
+                     FeedEvery / 3600, FeedEvery / 60 % 60, FeedEvery % 60);
+            Publish(Params);
+        }
+        if (Subscribed && SetN)
+        {
+            SetLeft = SetN;
+            SetNext = Now() + 1000000000ull; // 等待订阅后的首次上传
+        }
+    }
+    else if (strncmp(Cmd, "AT+MQTTPUB=", 11) == 0)
+    {
+        StatPubs++;
+        if (Connected && strstr(Cmd, POST_TOPIC))
+            Post(Cmd);
+        Result(Delay, Connected);
+    }
+    else if (sscanf(Cmd, "AT+SIMPUSH=%u,%u", &N, &Hz) == 2)
+    {
+        Result(0, 1);
+        StartPush(N, Hz);
+    }
+    else
+        Result(Delay, 0);
+}
+
+/**
+ * @brief  发送已到时的行, 受波特率限速
+ * @retval 距下一行发送时刻的毫秒数, 无待发送行时为-1
+ */
+static int Flush(void)
+{
+    uint64_t T = Now(), Due;
+    Out_TypeDef *O;
+    size_t Len;
+    ssize_t n;
+
+    while (OutHead != OutTail)
+    {
+        O = &Out[OutHead % OUT_MAX];
+        // 一行在其最后一字节发完时整行写出, 对端按行处理, 所见时刻与真实串口一致
+        Due = O->Due > LinkFree ? O->Due : LinkFree;
+        if ((O->Sent == 0) && Baud)
+            Due += strlen(O->Text) * 10ull * 1000000000ull / Baud;
+        if (Due > T)
+            return (int)((Due - T) / 1000000) + 1;
+        // 伪终端缓冲区满时可能只写入一部分, 余下部分留待下次
+        Len = strlen(O->Text + O->Sent);
+        n = write(Master, O->Text + O->Sent, Len);
+        if (n < 0)
+            return (errno == EAGAIN) ? 1 : -1;
+        if (O->Sent == 0)
+            LinkFree = Due;
+        O->Sent += n;
+        if ((size_t)n < Len)
+            return 1;
+        if (Verbose && (O->Sent > 2))
+            fprintf(stderr, "espsim -> %.*s\n", (int)O->Sent - 2, O->Text);
+        StatLines++;
+        OutHead++;
+    }
+    return -1;
+}
+
+static int Arg(int argc, char **argv, int *i, const char *Name)
+{
+    if (strcmp(argv[*i], Name) || (*i + 1 >= argc))
+        return 0;
+    (*i)++;
+    return 1;
+}
+
+int main(int argc, char **argv)
+{
+    char Line[LINE_MAX], *Slave, Ch;
+    uint32_t LineLen = 0;
+    struct termios Tio;
+    struct pollfd Pfd;
+    pid_t Child = 0;
+    int i, Status = 0, Timeout, Fd, Killed = 0;
+
+    for (i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--") == 0)
+        {
+            i++;
+            break;
+        }
+        if (Arg(argc, argv, &i, "--delay"))
+            Delay = atoi(argv[i]);
+        else if (Arg(argc, argv, &i, "--join"))
+            JoinDelay = atoi(argv[i]);
+        else if (Arg(argc, argv, &i, "--conn"))
+            ConnDelay = atoi(argv[i]);
+        else if (Arg(argc, argv, &i, "--boot"))
+            BootDelay = atoi(argv[i]);
+        else if (Arg(argc, argv, &i, "--baud"))
+            Baud = atoi(argv[i]);
+        else if (Arg(argc, argv, &i, "--drop"))
+            DropP = atof(argv[i]);
+        else if (Arg(argc, argv, &i, "--error"))
+            ErrorP = atof(argv[i]);
+        else if (Arg(argc, argv, &i, "--seed"))
+            Rand = strtoull(argv[i], NULL, 0) | 1;
+        else if (Arg(argc, argv, &i, "--push"))
+            sscanf(argv[i], "%u,%u", &AutoPushN, &AutoPushHz);
+        else if (Arg(argc, argv, &i, "--set"))
+        {
+            sscanf(argv[i], "%u,%u", &SetN, &SetHz);
+            if (SetN > SET_MAX)
+                SetN = SET_MAX;
+            SetPeriod = SetHz ? 1000000000ull / SetHz : 0;
+        }
+        else if (Arg(argc, argv, &i, "--feed"))
+            FeedEvery = atoi(argv[i]);
+        else if (Arg(argc, argv, &i, "--sntp"))
+            SntpDelay = atoi(argv[i]);
+        else if (Arg(argc, argv, &i, "--ntp-offset"))
+            NtpOffset = atol(argv[i]);
+        else if (strcmp(argv[i], "--verbose") == 0)
+            Verbose = 1;
+        else
+        {
+            fprintf(stderr, "espsim: unknown option %s (see Host/EspSim.c)\n", argv[i]);
+            return 2;
+        }
+    }
+
+    Master = posix_openpt(O_RDWR | O_NOCTTY);
+    if ((Master < 0) || grantpt(Master) || unlockpt(Master) || !(Slave = ptsname(Master)))
+    {
+        perror("espsim: pty");
+        return 1;
+    }
+    // 伪终端设为原始模式, 不做回显与换行转换
+    Fd = open(Slave, O_RDWR | O_NOCTTY);
+    tcgetattr(Fd, &Tio);
+    cfmakeraw(&Tio);
+    tcsetattr(Fd, TCSANOW, &Tio);
+    fcntl(Master, F_SETFL, fcntl(Master, F_GETFL) | O_NONBLOCK);
+
+    if (i < argc)
+    {
+        char **Args = calloc(argc - i + 2, sizeof(char *));
+        memcpy(Args, argv + i, (argc - i) * sizeof(char *));
+        Args[argc - i] = Slave;
+        Child = fork();
+        if (Child == 0)
+        {
+            close(Master);
+            close(Fd);
+            execvp(Args[0], Args);
+            perror(Args[0]);
+            _exit(127);
+        }
+    }
+    else
+    {
+        printf("%s\n", Slave);
+        fflush(stdout);
+    }
+
+    for (;;)
+    {
+        if (Child && (waitpid(Child, &Status, WNOHANG) == Child))
+            break;
+
+        // 订阅推送
+        while (PushLeft && Subscribed && (Now() >= PushNext))
+        {
+            Push();
+            PushLeft--;
+            PushNext += PushPeriod;
+        }
+        SetStep();
+        // 场景结束, 终止被测程序
+        if (Child && !Killed && SetN && Subscribed && !SetLeft && !SetPending)
+        {
+            kill(Child, SIGTERM);
+            Killed = 1;
+        }
+
+        Timeout = Flush();
+        if (PushLeft && Subscribed)
+        {
+            int PushWait = (int)((PushNext > Now() ? PushNext - Now() : 0) / 1000000);
+            if ((Timeout < 0) || (PushWait < Timeout))
+                Timeout = PushWait;
+        }
+        if ((Child || SetLeft) && ((Timeout < 0) || (Timeout > 20)))
+            Timeout = 20;
+
+        Pfd.fd = Master;
+        Pfd.events = POLLIN;
+        if (poll(&Pfd, 1, Timeout) <= 0)
+            continue;
+        while (read(Master, &Ch, 1) == 1)
+        {
+            if (Ch == '\n')
+            {
+                if (LineLen && (Line[LineLen - 1] == '\r'))
+                    LineLen--;
+                Line[LineLen] = '\0';
+                if (LineLen && Baud)
+                {
+                    uint64_t T = Now();
+                    RxFree = (RxFree > T ? RxFree : T) + (LineLen + 2) * 10ull * 1000000000ull / Baud;
+                    RxLag = RxFree - T;
+                }
+                if (LineLen)
+                    Command(Line);
+                RxLag = 0;
+                LineLen = 0;
+            }
+            else if (LineLen < sizeof(Line) - 1)
+                Line[LineLen++] = Ch;
+        }
+    }
+
+    fprintf(stderr, "espsim: %u commands (%u MQTTPUB), %u lines sent, %u dropped, %u ERROR injected, %u pushes\n",
+            StatCmds, StatPubs, StatLines, StatDropped, StatErrors, StatPushes);
+    if (StatPosts > 1)
+        fprintf(stderr, "espsim: property/post %u in %.1f s (%.2f/s, %.0f B/s on the link)\n", StatPosts,
+                (PostLast - PostFirst) / 1e9, (StatPosts - 1) * 1e9 / (PostLast - PostFirst),
+                PostBytes * 1e9 / (PostLast - PostFirst));
+    if (SetN)
+    {
+        qsort(SetMs, SetDone, sizeof(double), Cmp);
+        if (SetDone)
+            fprintf(stderr, "espsim: property/set -> post n=%u min %.1f p50 %.1f p99 %.1f max %.1f ms, %u timeouts\n",
+                    SetDone, SetMs[0], SetMs[SetDone / 2], SetMs[SetDone * 99 / 100], SetMs[SetDone - 1], SetTimeouts);
+        else
+            fprintf(stderr, "espsim: property/set -> post: no command took effect, %u timeouts\n", SetTimeouts);
+    }
+    if (Killed)
+        return (SetDone && !SetTimeouts) ? 0 : 1;
+    return WIFEXITED(Status) ? WEXITSTATUS(Status) : 1;
+}
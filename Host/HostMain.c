@@ -0,0 +1,84 @@
+#include "stm32f10x.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "Sim.h"
+
+/*
+ * 主机可执行文件入口. 固件的main()在主机构建时被重命名为App_Main(见Makefile).
+ *   firmware                  运行固件, 标准输入按键(w/s/a/d/e/q, b切换饵料不足)
+ *   firmware --esp <设备>     ESP8266经由该设备(串口或伪终端)收发
+ *   firmware --bench          运行热点函数基准测试后退出
+ *   firmware [--pubs N] [--pushes N] [--push-hz HZ] --esp-bench <设备>
+ *                             ESP8266链路基准测试(配网耗时、上传往返、接收压力), 通常由espsim启动
+ *   firmware --check <目录>   绘制各界面并与目录中的PBM基准图像比较, 不一致时返回非0
+ *   firmware --golden <目录>  绘制各界面并导出为新的基准图像
+ */
+
+int App_Main(void);
+int Bench_Run(void);
+int Screens_Run(const char *Dir, int Update);
+int EspBench_Run(uint32_t Pubs, uint32_t Pushes, uint32_t PushHz);
+
+static void Usage(const char *Name)
+{
+    fprintf(stderr, "usage: %s [--esp <device>] [--temp <celsius>] [--sensors <n>] [--ow-noise <n>] [--bench] [--check|--golden <dir>]\n"
+                    "       %s [--pubs N] [--pushes N] [--push-hz HZ] --esp-bench <device>\n", Name, Name);
+}
+
+int main(int argc, char **argv)
+{
+    int i;
+    unsigned Pubs = 100, Pushes = 1000, PushHz = 200;
+
+    for (i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--bench") == 0)
+            return Bench_Run();
+        else if ((strcmp(argv[i], "--check") == 0) && (i + 1 < argc))
+            return Screens_Run(argv[i + 1], 0) != 0;
+        else if ((strcmp(argv[i], "--golden") == 0) && (i + 1 < argc))
+            return Screens_Run(argv[i + 1], 1) != 0;
+        else if ((strcmp(argv[i], "--pubs") == 0) && (i + 1 < argc))
+            Pubs = atoi(argv[++i]);
+        else if ((strcmp(argv[i], "--pushes") == 0) && (i + 1 < argc))
+            Pushes = atoi(argv[++i]);
+        else if ((strcmp(argv[i], "--push-hz") == 0) && (i + 1 < argc))
+            PushHz = atoi(argv[++i]);
+        else if ((strcmp(argv[i], "--esp-bench") == 0) && (i + 1 < argc))
+        {
+            if (Sim_USART_Open(argv[i + 1]))
+            {
+                perror(argv[i + 1]);
+                return 1;
+            }
+            return EspBench_Run(Pubs, Pushes, PushHz);
+        }
+        else if ((strcmp(argv[i], "--esp") == 0) && (i + 1 < argc))
+        {
+            if (Sim_USART_Open(argv[++i]))
+            {
+                perror(argv[i]);
+                return 1;
+            }
+        }
+        else if ((strcmp(argv[i], "--temp") == 0) && (i + 1 < argc))
+            sscanf(argv[++i], "%f", &Sim_Temperature[0]);
+        else if ((strcmp(argv[i], "--ow-noise") == 0) && (i + 1 < argc))
+            Sim_OneWireNoise = atoi(argv[++i]);
+        else if ((strcmp(argv[i], "--sensors") == 0) && (i + 1 < argc))
+        {
+            Sim_DS18B20_N = atoi(argv[++i]);
+            if (Sim_DS18B20_N > SIM_DS18B20_MAX)
+                Sim_DS18B20_N = SIM_DS18B20_MAX;
+        }
+        else
+        {
+            Usage(argv[0]);
+            return 1;
+        }
+    }
+
+    Sim_KeyStdin(1);
+    return App_Main();
+}
@@ -0,0 +1,459 @@
+#include "stm32f10x.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "MyRTC.h"
+
+/*
+ * System/MyRTC.c的主机测试: 板上源文件原样编译, RTC与BKP按寄存器行为在此实现.
+ * LSE模型: 真实时间每秒产生32768×(1+误差ppm)个时钟, BKP_RTCCR每2^20个时钟去掉CAL个, 每(分频系数+1)个时钟计数值加1;
+ * 计数值变化时置位秒标志, 由ALR变为ALR+1时置位闹钟标志, 已使能的中断立即调用RTC_IRQHandler.
+ * 网络时间取真实时间的整数秒. 任一检查失败时返回非0.
+ *
+ * 投饵时刻: Calendar_NextDeadline的周期时刻计算, 以及MyRTC的闹钟排定、断电补投(MYRTC_CATCHUP,
+ * Makefile以两种取值各编译一次)与网络校时调整计数值时的处理.
+ */
+
+#define RTCTEST_UTC0 1767225600u // 测试起点: 2026-01-01 00:00:00 UTC
+
+RTC_TypeDef RtcTest_RTC;
+
+static uint16_t RtcTest_BKP[11];    // BKP_DR1~DR10, 下标即编号
+static uint8_t RtcTest_Cal;         // BKP_RTCCR校准值
+static uint32_t RtcTest_Counter;    // RTC计数值
+static uint32_t RtcTest_Prl;        // 分频系数
+static uint32_t RtcTest_Alr;        // 闹钟值
+static uint16_t RtcTest_Pending;    // 中断标志
+static double RtcTest_Cycles;       // 分频器中累计的LSE时钟数
+static double RtcTest_Ppm;          // LSE频率误差
+static double RtcTest_Utc;          // 真实时间, UTC秒数
+static uint8_t RtcTest_CpuOff;      // 断电标志: RTC由VBAT供电照常计数, 但不执行中断
+
+static unsigned RtcTest_Checks, RtcTest_Failed;
+
+void RCC_APB1PeriphClockCmd(uint32_t Periph, FunctionalState NewState) { (void)Periph; (void)NewState; }
+void RCC_LSEConfig(uint8_t LSE) { (void)LSE; }
+FlagStatus RCC_GetFlagStatus(uint8_t Flag) { (void)Flag; return SET; }
+void RCC_RTCCLKConfig(uint32_t Source) { (void)Source; }
+void RCC_RTCCLKCmd(FunctionalState NewState) { (void)NewState; }
+void PWR_BackupAccessCmd(FunctionalState NewState) { (void)NewState; }
+void EXTI_Init(EXTI_InitTypeDef *Init) { (void)Init; }
+void NVIC_Init(NVIC_InitTypeDef *Init) { (void)Init; }
+void RTC_EnterConfigMode(void) {}
+void RTC_ExitConfigMode(void) {}
+void RTC_WaitForLastTask(void) {}
+void RTC_WaitForSynchro(void) {}
+
+uint16_t BKP_ReadBackupRegister(uint16_t DR)
+{
+    return RtcTest_BKP[DR];
+}
+
+void BKP_WriteBackupRegister(uint16_t DR, uint16_t Data)
+{
+    RtcTest_BKP[DR] = Data;
+}
+
+void BKP_SetRTCCalibrationValue(uint8_t CalibrationValue)
+{
+    RtcTest_Cal = CalibrationValue & 0x7F;
+}
+
+void RTC_ITConfig(uint16_t IT, FunctionalState NewState)
+{
+    if (NewState)
+        RTC->CRH |= IT;
+    else
+        RTC->CRH &= ~IT;
+}
+
+uint32_t RTC_GetCounter(void)
+{
+    return RtcTest_Counter;
+}
+
+void RTC_SetCounter(uint32_t CounterValue)
+{
+    RtcTest_Counter = CounterValue;
+}
+
+void RTC_SetPrescaler(uint32_t PrescalerValue)
+{
+    RtcTest_Prl = PrescalerValue;
+}
+
+void RTC_SetAlarm(uint32_t AlarmValue)
+{
+    RtcTest_Alr = AlarmValue;
+}
+
+ITStatus RTC_GetITStatus(uint16_t IT)
+{
+    return ((RtcTest_Pending & IT) && (RTC->CRH & IT)) ? SET : RESET;
+}
+
+void RTC_ClearITPendingBit(uint16_t IT)
+{
+    RtcTest_Pending &= ~IT;
+}
+
+/**
+ * @brief  真实时间前进, 按LSE模型推进计数值并处理中断
+ * @param  Seconds 秒数
+ * @retval 无
+ */
+static void RtcTest_Run(double Seconds)
+{
+    RtcTest_Utc += Seconds;
+    RtcTest_Cycles += Seconds * 32768.0 * (1 + RtcTest_Ppm * 1e-6) * (1 - RtcTest_Cal / 1048576.0);
+    while (RtcTest_Cycles >= RtcTest_Prl + 1)
+    {
+        RtcTest_Cycles -= RtcTest_Prl + 1;
+        RtcTest_Counter++;
+        RtcTest_Pending |= RTC_IT_SEC;
+        if (RtcTest_Counter == RtcTest_Alr + 1)
+            RtcTest_Pending |= RTC_IT_ALR;
+        if (!RtcTest_CpuOff && (RtcTest_Pending & RTC->CRH))
+            RTC_IRQHandler();
+    }
+}
+
+/**
+ * @brief  VBAT断电后首次上电: 清空备份域, 初始化RTC
+ * @param  Ppm LSE频率误差
+ * @retval 无
+ */
+static void RtcTest_PowerOn(double Ppm)
+{
+    memset(RtcTest_BKP, 0, sizeof(RtcTest_BKP));
+    RtcTest_Cal = 0;
+    RtcTest_Counter = 0;
+    RtcTest_Prl = 32767;
+    RtcTest_Alr = 0xFFFFFFFF;
+    RtcTest_Pending = 0;
+    RtcTest_Cycles = 0;
+    RtcTest_Ppm = Ppm;
+    RtcTest_Utc = RTCTEST_UTC0 + 0.4;
+    RtcTest_CpuOff = 0;
+    RTC->CRH = 0;
+    MyRTC_Init();
+}
+
+// 网络时间(真实时间的整数秒)
+static uint32_t RtcTest_Now(void)
+{
+    return (uint32_t)RtcTest_Utc;
+}
+
+// 上次调整时的网络时间(BKP_DR6/DR7)
+static uint32_t RtcTest_Ref(void)
+{
+    return RtcTest_BKP[6] | ((uint32_t)RtcTest_BKP[7] << 16);
+}
+
+// 当前RTC实际速率相对真实时间的误差, ppm
+static double RtcTest_Residual(void)
+{
+    return ((1 + RtcTest_Ppm * 1e-6) * (1 - RtcTest_Cal / 1048576.0) * 32768.0 / (RtcTest_Prl + 1) - 1) * 1e6;
+}
+
+static void RtcTest_Check(int Ok, const char *Name, const char *What)
+{
+    RtcTest_Checks++;
+    if (Ok)
+        return;
+    RtcTest_Failed++;
+    printf("FAIL %s: %s\n", Name, What);
+}
+
+/**
+ * @brief  校准收敛: 每小时网络校时一次, 共30天. 偏差不超过1秒时不调整, 因此第7天以后每次校时前的偏差不超过2秒;
+ *         结束时校准值、分频系数与BKP_RTCCR一致, 剩余频率误差在4ppm(每天0.35秒)以内.
+ *         网络时间与计数值都只有整秒, 剩余误差主要来自测量时长内±1秒的量化
+ * @param  Ppm LSE频率误差
+ * @retval 无
+ */
+static void RtcTest_Converge(double Ppm)
+{
+    char Name[32];
+    int32_t Err, ErrMax = 0;
+    int16_t Calib;
+    uint32_t Hour;
+
+    snprintf(Name, sizeof(Name), "converge %+.0f ppm", Ppm);
+    RtcTest_PowerOn(Ppm);
+    MyRTC_Sync(RtcTest_Now());
+    RtcTest_Check(RtcTest_Counter == RtcTest_Now(), Name, "first sync sets the counter");
+
+    for (Hour = 1; Hour <= 30 * 24; Hour++)
+    {
+        RtcTest_Run(3600);
+        Err = (int32_t)(RtcTest_Counter - RtcTest_Now());
+        if ((Hour > 7 * 24) && (abs(Err) > ErrMax))
+            ErrMax = abs(Err);
+        MyRTC_Sync(RtcTest_Now());
+    }
+
+    Calib = (int16_t)RtcTest_BKP[8];
+    printf("%-28s calib %4d  prescaler %u  cal %3u  residual %+5.2f ppm  max err %d s\n",
+           Name, Calib, (unsigned)RtcTest_Prl + 1, RtcTest_Cal, RtcTest_Residual(), (int)ErrMax);
+    RtcTest_Check(ErrMax <= 2, Name, "error stays within 2 s after day 7");
+    RtcTest_Check(fabs(RtcTest_Residual()) < 4, Name, "residual below 4 ppm");
+    if (Calib >= 0)
+        RtcTest_Check((RtcTest_Prl == 32767) && (RtcTest_Cal == Calib), Name, "prescaler 32768 and CAL = calib");
+    else
+        RtcTest_Check((RtcTest_Prl == 32766) && (RtcTest_Cal == Calib + 32), Name, "prescaler 32767 and CAL = calib + 32");
+}
+
+/**
+ * @brief  距上次调整不足MYRTC_CALIB_MIN_TIME时只调整计数值; 满该时长后按偏差修正校准值, 超出下限时取下限
+ */
+static void RtcTest_MinTime(void)
+{
+    const char *Name = "calib min time";
+    uint32_t Ref;
+
+    RtcTest_PowerOn(0);
+    MyRTC_Sync(RtcTest_Now());
+
+    RtcTest_Run(MYRTC_CALIB_MIN_TIME - 3600);
+    RtcTest_Counter += 5;
+    Ref = RtcTest_Now();
+    MyRTC_Sync(Ref);
+    RtcTest_Check(RtcTest_Counter == Ref, Name, "5 s error before 6 h steps the counter");
+    RtcTest_Check(RtcTest_BKP[8] == 0, Name, "5 s error before 6 h leaves calib unchanged");
+    RtcTest_Check(RtcTest_Ref() == Ref, Name, "step moves the reference");
+
+    RtcTest_Run(MYRTC_CALIB_MIN_TIME);
+    RtcTest_Counter += 2;
+    MyRTC_Sync(RtcTest_Now());
+    RtcTest_Check((int16_t)RtcTest_BKP[8] == 2 * 1048576 / MYRTC_CALIB_MIN_TIME, Name, "2 s error after 6 h updates calib");
+
+    RtcTest_PowerOn(0);
+    MyRTC_Sync(RtcTest_Now());
+    RtcTest_Run(MYRTC_CALIB_MIN_TIME);
+    RtcTest_Counter -= 3;
+    MyRTC_Sync(RtcTest_Now());
+    RtcTest_Check((int16_t)RtcTest_BKP[8] == MYRTC_CALIB_MIN, Name, "calib clamps at the lower limit");
+    RtcTest_Check((RtcTest_Prl == 32766) && (RtcTest_Cal == 0), Name, "lower limit is prescaler 32767 with CAL 0");
+}
+
+/**
+ * @brief  偏差在1秒以内时不调整, 但距上次调整满MYRTC_CALIB_PERIOD后调整一次
+ */
+static void RtcTest_Period(void)
+{
+    const char *Name = "calib period";
+    uint32_t Ref, Hour, Moved = 0;
+
+    RtcTest_PowerOn(0);
+    Ref = RtcTest_Now();
+    MyRTC_Sync(Ref);
+    for (Hour = 1; Hour <= 4 * 24; Hour++)
+    {
+        RtcTest_Run(3600);
+        MyRTC_Sync(RtcTest_Now());
+        if (!Moved && (RtcTest_Ref() != Ref))
+            Moved = RtcTest_Now() - Ref;
+    }
+    RtcTest_Check(Moved == MYRTC_CALIB_PERIOD, Name, "reference moves at the first sync after 3 days");
+    RtcTest_Check(RtcTest_BKP[8] == 0, Name, "exact crystal keeps calib 0");
+}
+
+/**
+ * @brief  偏差超过MYRTC_CALIB_ERR_MAX(时间原本不准)时只调整计数值; 手动设置时间后清除调整起点
+ */
+static void RtcTest_ErrMax(void)
+{
+    const char *Name = "calib err max";
+    Calendar_TypeDef Time;
+
+    RtcTest_PowerOn(0);
+    MyRTC_Sync(RtcTest_Now());
+    RtcTest_Run(MYRTC_CALIB_MIN_TIME + 3600);
+    RtcTest_Counter += MYRTC_CALIB_ERR_MAX + 1;
+    MyRTC_Sync(RtcTest_Now());
+    RtcTest_Check(RtcTest_Counter == RtcTest_Now(), Name, "large error steps the counter");
+    RtcTest_Check(RtcTest_BKP[8] == 0, Name, "large error leaves calib unchanged");
+
+    MyRTC_GetTime(&Time);
+    MyRTC_SetTime(&Time);
+    RtcTest_Check(RtcTest_Ref() == 0, Name, "manual time clears the reference");
+    RtcTest_Run(MYRTC_CALIB_MIN_TIME + 3600);
+    RtcTest_Counter += 3;
+    MyRTC_Sync(RtcTest_Now());
+    RtcTest_Check(RtcTest_BKP[8] == 0, Name, "first sync after manual time does not calibrate");
+}
+
+/**
+ * @brief  周期时刻计算: 保留窗口内的预定时刻, 错过、不在周期时刻上或超前一个周期以上时重算; 负的平移
+ */
+static void RtcTest_Deadline(void)
+{
+    const char *Name = "deadline";
+
+    RtcTest_Check(Calendar_NextDeadline(1080, 1020, 60, 0) == 1080, Name, "deadline one period ahead is kept");
+    RtcTest_Check(Calendar_NextDeadline(1020, 1000, 60, 0) == 1020, Name, "deadline inside the window is kept");
+    RtcTest_Check(Calendar_NextDeadline(1030, 1000, 60, 0) == 1020, Name, "off-grid deadline moves to the grid");
+    RtcTest_Check(Calendar_NextDeadline(1000, 1000, 60, 0) == 1020, Name, "missed deadline moves to the next grid point");
+    RtcTest_Check(Calendar_NextDeadline(1140, 1000, 60, 0) == 1020, Name, "deadline beyond one period is pulled back");
+    RtcTest_Check(Calendar_NextDeadline(0, 1020, 60, 0) == 1080, Name, "now on the grid gives the next point");
+    // UTC-5, 每6小时: 本地0、6、12、18点, 即UTC 5、11、17、23点
+    RtcTest_Check(Calendar_NextDeadline(0, RTCTEST_UTC0, 21600, -300 * 60) == RTCTEST_UTC0 + 5 * 3600, Name,
+                  "negative offset aligns to local midnight");
+    // UTC+8, 每小时, 相位30分
+    RtcTest_Check(Calendar_NextDeadline(0, RTCTEST_UTC0, 3600, 480 * 60 - 1800) == RTCTEST_UTC0 + 1800, Name,
+                  "phase shifts the grid");
+}
+
+/**
+ * @brief  设置投饵间隔并开启闹钟, 同设置界面保存
+ */
+static void RtcTest_SetInterval(uint8_t Hour, uint8_t Minute, uint8_t Second)
+{
+    uint8_t Interval[3] = {Hour, Minute, Second};
+
+    MyRTC_SaveInterval(Interval);
+    MyRTC_SetAlarm(Interval);
+}
+
+/**
+ * @brief  逐秒运行直到闹钟到时
+ * @param  Max 最多运行的秒数
+ * @retval 到时时的计数值, 0表示未到时
+ */
+static uint32_t RtcTest_UntilAlarm(uint32_t Max)
+{
+    while (Max--)
+    {
+        RtcTest_Run(1);
+        if (MyRTC_GetAlarm())
+            return RtcTest_Counter;
+    }
+    return 0;
+}
+
+/**
+ * @brief  断电Seconds秒后重新上电(备份域保持), 按main中的顺序初始化RTC并开启闹钟
+ */
+static void RtcTest_PowerCycle(uint32_t Seconds)
+{
+    uint8_t Interval[3];
+
+    RtcTest_CpuOff = 1;
+    RtcTest_Run(Seconds);
+    RtcTest_CpuOff = 0;
+    RTC->CRH = 0;
+    RtcTest_Pending = 0;
+    MyRTC_Init();
+    MyRTC_SetAlarm(Interval);
+}
+
+/**
+ * @brief  闹钟按本地时间的投饵时刻到时, 不随到时处理推迟; UTC偏移为负时同样对齐本地0点; 间隔为0时关闭
+ */
+static void RtcTest_Grid(void)
+{
+    const char *Name = "feed grid";
+    Calendar_TypeDef Time;
+    uint32_t At, Last = 0, n, Late = 0;
+
+    RtcTest_PowerOn(0);
+    MyRTC_Sync(RtcTest_Now());
+    MyRTC_SetOffset(480);
+    RtcTest_Run(100);
+    RtcTest_SetInterval(1, 0, 0);
+    for (n = 0; n < 5; n++)
+    {
+        At = RtcTest_UntilAlarm(3700);
+        MyRTC_GetTime(&Time);
+        if ((At == 0) || (Time.Minute != 0) || (Time.Second != 0) || (Last && (At - Last != 3600)))
+            Late++;
+        Last = At;
+        RtcTest_Run(3); // 投饵动作期间闹钟保持开启
+    }
+    RtcTest_Check(Late == 0, Name, "hourly feeds fire on the local hour");
+
+    MyRTC_SetOffset(330); // 改变UTC偏移后投饵时刻对齐新的本地整点
+    At = RtcTest_UntilAlarm(3700);
+    MyRTC_GetTime(&Time);
+    RtcTest_Check((At != 0) && (At % 3600 == 1800) && (Time.Minute == 0) && (Time.Second == 0), Name,
+                  "offset change realigns the grid to the new local hour");
+
+    MyRTC_SetOffset(-300);
+    RtcTest_SetInterval(6, 0, 0);
+    At = RtcTest_UntilAlarm(6 * 3600 + 10);
+    MyRTC_GetTime(&Time);
+    RtcTest_Check((At != 0) && (Time.Hour % 6 == 0) && (Time.Minute == 0) && (Time.Second == 0), Name,
+                  "6 h feeds at UTC-5 fire at local 0/6/12/18 h");
+
+    RtcTest_SetInterval(0, 0, 0);
+    RtcTest_Check(!(RTC->CRH & RTC_IT_ALR) && (RtcTest_UntilAlarm(2 * 3600) == 0), Name, "interval 0 disables the alarm");
+}
+
+/**
+ * @brief  断电期间错过的投饵时刻: MYRTC_CATCHUP_ONCE时上电后补投一次, SKIP时不补; 闹钟关闭期间断电不补
+ */
+static void RtcTest_CatchUp(void)
+{
+    const char *Name = (MYRTC_CATCHUP == MYRTC_CATCHUP_ONCE) ? "catch-up once" : "catch-up skip";
+    uint32_t Next, At;
+
+    RtcTest_PowerOn(0);
+    MyRTC_Sync(RtcTest_Now());
+    RtcTest_SetInterval(1, 0, 0);
+    Next = RtcTest_UntilAlarm(3700) + 3600;
+    RtcTest_Run(3600 - 10);
+    RtcTest_PowerCycle(3 * 3600);
+    RtcTest_Check(MyRTC_GetAlarm() == (MYRTC_CATCHUP == MYRTC_CATCHUP_ONCE), Name, "missed feeds while powered off");
+    At = RtcTest_UntilAlarm(3700);
+    RtcTest_Check(At == Next + 3 * 3600, Name, "schedule resumes on the grid after power-on");
+
+    MyRTC_AlarmOff();
+    RtcTest_PowerCycle(3 * 3600);
+    RtcTest_Check(MyRTC_GetAlarm() == 0, Name, "no catch-up when the alarm was off");
+}
+
+/**
+ * @brief  网络校时调整计数值: 调快时越过的投饵时刻跳过, 调回时已到过的投饵时刻不再重复
+ */
+static void RtcTest_Step(void)
+{
+    const char *Name = "feed step";
+    uint32_t Due, At;
+
+    RtcTest_PowerOn(0);
+    MyRTC_Sync(RtcTest_Now());
+    RtcTest_SetInterval(1, 0, 0);
+    Due = RtcTest_UntilAlarm(3700) + 3600;
+
+    RtcTest_Run(3600 - 600);
+    MyRTC_Sync(RtcTest_Counter + 1200); // RTC慢20分钟
+    At = RtcTest_UntilAlarm(7200);
+    RtcTest_Check(At == Due + 3600, Name, "forward step skips the deadline it jumps over");
+
+    RtcTest_Run(300);
+    MyRTC_Sync(RtcTest_Counter - 1200); // RTC快20分钟
+    At = RtcTest_UntilAlarm(7200);
+    RtcTest_Check(At == Due + 2 * 3600, Name, "backward step does not repeat the deadline already fired");
+}
+
+int main(void)
+{
+    static const double Ppm[] = {-25, -10, 0, 20, 80};
+    uint8_t i;
+
+    for (i = 0; i < sizeof(Ppm) / sizeof(Ppm[0]); i++)
+        RtcTest_Converge(Ppm[i]);
+    RtcTest_MinTime();
+    RtcTest_Period();
+    RtcTest_ErrMax();
+    RtcTest_Deadline();
+    RtcTest_Grid();
+    RtcTest_CatchUp();
+    RtcTest_Step();
+
+    printf("rtctest: %u checks, %u failed\n", RtcTest_Checks, RtcTest_Failed);
+    return RtcTest_Failed != 0;
+}
@@ -0,0 +1,94 @@
+/**
+ * RTC测试(RtcTest.c)用的stm32f10x.h替身: 只声明System/MyRTC.c用到的RTC、BKP、RCC、PWR、EXTI、NVIC
+ * 寄存器与库函数, 由RtcTest.c按寄存器行为实现(含LSE频率误差模型), 使板上的MyRTC.c原样在主机上运行.
+ */
+#ifndef __STM32F10x_H
+#define __STM32F10x_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+typedef enum {RESET = 0, SET = !RESET} FlagStatus, ITStatus;
+typedef enum {DISABLE = 0, ENABLE = !DISABLE} FunctionalState;
+
+typedef struct
+{
+    volatile uint16_t CRH; // 中断使能位: RTC_IT_xxx
+} RTC_TypeDef;
+
+extern RTC_TypeDef RtcTest_RTC;
+#define RTC (&RtcTest_RTC)
+
+#define RTC_IT_OW ((uint16_t)0x0004)
+#define RTC_IT_ALR ((uint16_t)0x0002)
+#define RTC_IT_SEC ((uint16_t)0x0001)
+
+// 备份数据寄存器以编号代替地址偏移
+#define BKP_DR1 1
+#define BKP_DR2 2
+#define BKP_DR3 3
+#define BKP_DR4 4
+#define BKP_DR5 5
+#define BKP_DR6 6
+#define BKP_DR7 7
+#define BKP_DR8 8
+#define BKP_DR9 9
+#define BKP_DR10 10
+
+#define RCC_APB1Periph_PWR 0x10000000
+#define RCC_APB1Periph_BKP 0x08000000
+#define RCC_LSE_ON 1
+#define RCC_FLAG_LSERDY 0x41
+#define RCC_RTCCLKSource_LSE 0x100
+
+#define EXTI_Line17 0x20000
+typedef enum {EXTI_Mode_Interrupt = 0x00} EXTIMode_TypeDef;
+typedef enum {EXTI_Trigger_Falling = 0x0C} EXTITrigger_TypeDef;
+typedef struct
+{
+    uint32_t EXTI_Line;
+    EXTIMode_TypeDef EXTI_Mode;
+    EXTITrigger_TypeDef EXTI_Trigger;
+    FunctionalState EXTI_LineCmd;
+} EXTI_InitTypeDef;
+
+#define RTC_IRQn 3
+typedef struct
+{
+    uint8_t NVIC_IRQChannel;
+    uint8_t NVIC_IRQChannelPreemptionPriority;
+    uint8_t NVIC_IRQChannelSubPriority;
+    FunctionalState NVIC_IRQChannelCmd;
+} NVIC_InitTypeDef;
+
+// 主机上没有中断, 测试程序在计数值变化后同步调用RTC_IRQHandler
+static inline void __disable_irq(void) {}
+static inline void __enable_irq(void) {}
+
+void RCC_APB1PeriphClockCmd(uint32_t Periph, FunctionalState NewState);
+void RCC_LSEConfig(uint8_t LSE);
+FlagStatus RCC_GetFlagStatus(uint8_t Flag);
+void RCC_RTCCLKConfig(uint32_t Source);
+void RCC_RTCCLKCmd(FunctionalState NewState);
+void PWR_BackupAccessCmd(FunctionalState NewState);
+void EXTI_Init(EXTI_InitTypeDef *Init);
+void NVIC_Init(NVIC_InitTypeDef *Init);
+
+uint16_t BKP_ReadBackupRegister(uint16_t DR);
+void BKP_WriteBackupRegister(uint16_t DR, uint16_t Data);
+void BKP_SetRTCCalibrationValue(uint8_t CalibrationValue);
+
+void RTC_ITConfig(uint16_t IT, FunctionalState NewState);
+void RTC_EnterConfigMode(void);
+void RTC_ExitConfigMode(void);
+uint32_t RTC_GetCounter(void);
+void RTC_SetCounter(uint32_t CounterValue);
+void RTC_SetPrescaler(uint32_t PrescalerValue);
+void RTC_SetAlarm(uint32_t AlarmValue);
+void RTC_WaitForLastTask(void);
+void RTC_WaitForSynchro(void);
+ITStatus RTC_GetITStatus(uint16_t IT);
+void RTC_ClearITPendingBit(uint16_t IT);
+void RTC_IRQHandler(void);
+
+#endif
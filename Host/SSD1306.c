@@ -0,0 +1,284 @@
+#include "stm32f10x.h"
+#include <stdio.h>
+#include <string.h>
+#include "SSD1306.h"
+
+uint32_t SSD1306_BusHz = 400000;
+
+static uint8_t GDDRAM[8][128]; // [页][列]
+
+static uint8_t Mode = 2;                 // 寻址模式. 0:水平 | 1:垂直 | 2:页
+static uint8_t ColS = 0, ColE = 127;     // 列地址窗口(水平/垂直寻址)
+static uint8_t PageS = 0, PageE = 7;     // 页地址窗口(水平/垂直寻址)
+static uint8_t Col = 0, Page = 0;        // 当前写入位置
+static uint8_t DisplayOn = 0;            // 0xAE/0xAF
+static uint8_t SegRemap = 0;             // 0xA0/0xA1
+static uint8_t ComRemap = 0;             // 0xC0/0xC8
+static uint8_t Invert = 0;               // 0xA6/0xA7
+static uint8_t AllOn = 0;                // 0xA4/0xA5
+
+static uint8_t Cmd[8];    // 正在接收的多字节命令
+static uint8_t CmdLen = 0; // 已接收字节数
+static uint8_t CmdNeed = 0; // 命令总字节数
+
+static SSD1306_Stats Stats;
+
+/**
+ * @brief  命令总字节数(含参数)
+ */
+static uint8_t SSD1306_CmdSize(uint8_t Op)
+{
+    switch (Op)
+    {
+    case 0x20: case 0x81: case 0x8D: case 0xA8: case 0xD3:
+    case 0xD5: case 0xD9: case 0xDA: case 0xDB:
+        return 2;
+    case 0x21: case 0x22: case 0xA3:
+        return 3;
+    case 0x29: case 0x2A:
+        return 6;
+    case 0x26: case 0x27:
+        return 7;
+    default:
+        return 1;
+    }
+}
+
+static void SSD1306_Exec(void)
+{
+    uint8_t Op = Cmd[0];
+
+    if (Op <= 0x0F) // 页寻址: 列地址低4位
+    {
+        if (Mode != 2)
+            Stats.Warnings++;
+        Col = (Col & 0xF0) | Op;
+    }
+    else if (Op <= 0x1F) // 页寻址: 列地址高4位
+    {
+        if (Mode != 2)
+            Stats.Warnings++;
+        Col = (Col & 0x0F) | ((Op & 0x0F) << 4);
+    }
+    else if ((Op >= 0xB0) && (Op <= 0xB7)) // 页寻址: 页地址
+    {
+        if (Mode != 2)
+            Stats.Warnings++;
+        Page = Op & 0x07;
+    }
+    else if (Op == 0x20)
+        Mode = Cmd[1] & 0x03;
+    else if (Op == 0x21)
+    {
+        ColS = Cmd[1] & 0x7F;
+        ColE = Cmd[2] & 0x7F;
+        Col = ColS;
+    }
+    else if (Op == 0x22)
+    {
+        PageS = Cmd[1] & 0x07;
+        PageE = Cmd[2] & 0x07;
+        Page = PageS;
+    }
+    else if ((Op == 0xAE) || (Op == 0xAF))
+        DisplayOn = Op & 1;
+    else if ((Op == 0xA0) || (Op == 0xA1))
+        SegRemap = Op & 1;
+    else if ((Op == 0xC0) || (Op == 0xC8))
+        ComRemap = (Op == 0xC8);
+    else if ((Op == 0xA6) || (Op == 0xA7))
+        Invert = Op & 1;
+    else if ((Op == 0xA4) || (Op == 0xA5))
+        AllOn = Op & 1;
+    else if ((Op >= 0x40) && (Op <= 0x7F)) // 显示开始行, 固件固定为0
+        ;
+    else if ((Op == 0x2E) || (Op == 0x2F) || (Op == 0xE3) || (SSD1306_CmdSize(Op) > 1))
+        ; // 滚动、空操作及其余带参数的配置命令不影响GDDRAM
+    else
+        Stats.Warnings++;
+}
+
+static void SSD1306_Command(uint8_t Byte)
+{
+    if (CmdLen == 0)
+        CmdNeed = SSD1306_CmdSize(Byte);
+    Cmd[CmdLen++] = Byte;
+    if (CmdLen == CmdNeed)
+    {
+        SSD1306_Exec();
+        CmdLen = 0;
+    }
+}
+
+static void SSD1306_Data(uint8_t Byte)
+{
+    GDDRAM[Page & 7][Col & 127] = Byte;
+
+    if (Mode == 2)
+    {
+        if (Col < 127)
+            Col++;
+        else
+            Col = ColS; // 页寻址: 到行尾后回到起始列, 页不变
+    }
+    else if (Mode == 0)
+    {
+        if (Col < ColE)
+            Col++;
+        else
+        {
+            Col = ColS;
+            Page = (Page < PageE) ? Page + 1 : PageS;
+        }
+    }
+    else
+    {
+        if (Page < PageE)
+            Page++;
+        else
+        {
+            Page = PageS;
+            Col = (Col < ColE) ? Col + 1 : ColS;
+        }
+    }
+}
+
+/**
+ * @brief  复位: 清空GDDRAM, 恢复上电默认寄存器值(页寻址、熄屏)
+ */
+void SSD1306_Reset(void)
+{
+    memset(GDDRAM, 0, sizeof(GDDRAM));
+    Mode = 2;
+    ColS = Col = 0;
+    ColE = 127;
+    PageS = Page = 0;
+    PageE = 7;
+    DisplayOn = SegRemap = ComRemap = Invert = AllOn = 0;
+    CmdLen = 0;
+}
+
+/**
+ * @brief  接收一次I2C写传输(从机地址之后的全部字节).
+ *         控制字节Co=0时其后全部为命令(D/C#=0)或数据(D/C#=1);
+ *         Co=1时其后只有一个字节, 之后再跟一个控制字节
+ * @param  Buf 控制字节及负载
+ * @param  Len 字节数
+ */
+void SSD1306_Write(const uint8_t *Buf, uint16_t Len)
+{
+    uint16_t i = 0;
+    uint8_t Control;
+
+    Stats.Trans++;
+    Stats.Bytes += 1 + Len;
+    // 起始+停止约2位, 每字节8位数据+1位应答
+    Stats.BusNs += (uint64_t)((1 + Len) * 9 + 2) * 1000000000ull / SSD1306_BusHz;
+
+    while (i < Len)
+    {
+        Control = Buf[i++];
+        if (Control & 0x80) // Co=1: 单字节
+        {
+            if (i < Len)
+            {
+                if (Control & 0x40)
+                    SSD1306_Data(Buf[i]);
+                else
+                    SSD1306_Command(Buf[i]);
+                i++;
+            }
+            continue;
+        }
+        for (; i < Len; i++)
+        {
+            if (Control & 0x40)
+                SSD1306_Data(Buf[i]);
+            else
+                SSD1306_Command(Buf[i]);
+        }
+    }
+}
+
+void SSD1306_GetStats(SSD1306_Stats *Out)
+{
+    *Out = Stats;
+}
+
+void SSD1306_ClearStats(void)
+{
+    memset(&Stats, 0, sizeof(Stats));
+}
+
+/**
+ * @brief  读取屏幕上显示的像素, 已计入左右/上下反置、反色、全亮与熄屏.
+ *         固件以0xA1、0xC8为正常方向, 此时像素与GDDRAM的页/列一一对应
+ * @param  X 列, 0~127, 自左向右
+ * @param  Y 行, 0~63, 自上向下
+ * @retval 1:点亮 | 0:熄灭
+ */
+uint8_t SSD1306_Pixel(uint8_t X, uint8_t Y)
+{
+    uint8_t Bit;
+
+    if (!DisplayOn)
+        return 0;
+    if (AllOn)
+        return 1;
+    if (!SegRemap)
+        X = 127 - X;
+    if (!ComRemap)
+        Y = 63 - Y;
+    Bit = (GDDRAM[Y >> 3][X] >> (Y & 7)) & 1;
+    return Bit ^ Invert;
+}
+
+/**
+ * @brief  以PBM(P1, 文本)格式导出当前画面
+ * @retval 0:成功 | -1:文件无法写入
+ */
+int SSD1306_DumpPBM(const char *Path)
+{
+    FILE *F = fopen(Path, "w");
+    uint8_t X, Y;
+
+    if (!F)
+        return -1;
+    fprintf(F, "P1\n%d %d\n", SSD1306_WIDTH, SSD1306_HEIGHT);
+    for (Y = 0; Y < SSD1306_HEIGHT; Y++)
+    {
+        for (X = 0; X < SSD1306_WIDTH; X++)
+            fputc(SSD1306_Pixel(X, Y) ? '1' : '0', F);
+        fputc('\n', F);
+    }
+    fclose(F);
+    return 0;
+}
+
+/**
+ * @brief  与PBM(P1)基准图像比较
+ * @retval 不同的像素数 | -1:文件无法读取或格式不符
+ */
+int SSD1306_ComparePBM(const char *Path)
+{
+    FILE *F = fopen(Path, "r");
+    int W, H, Ch, Diff = 0, N = 0;
+
+    if (!F)
+        return -1;
+    if ((fscanf(F, "P1 %d %d", &W, &H) != 2) || (W != SSD1306_WIDTH) || (H != SSD1306_HEIGHT))
+    {
+        fclose(F);
+        return -1;
+    }
+    while ((N < W * H) && ((Ch = fgetc(F)) != EOF))
+    {
+        if ((Ch != '0') && (Ch != '1'))
+            continue;
+        if ((Ch - '0') != SSD1306_Pixel(N % W, N / W))
+            Diff++;
+        N++;
+    }
+    fclose(F);
+    return (N == W * H) ? Diff : -1;
+}
@@ -0,0 +1,31 @@
+#ifndef __SSD1306_H
+#define __SSD1306_H
+
+/*
+ * SSD1306(128x64, I2C)仿真, 仅主机构建使用.
+ * 接收OLED_Bus层发出的每次I2C传输(从机地址之后的控制字节与负载),
+ * 解码命令并维护GDDRAM, 可导出PBM图像并与基准图像比较.
+ */
+
+#define SSD1306_WIDTH 128
+#define SSD1306_HEIGHT 64
+
+typedef struct
+{
+    uint32_t Bytes;    // 总线字节数(含从机地址与控制字节)
+    uint32_t Trans;    // 传输次数
+    uint64_t BusNs;    // 按总线时钟折算的传输时间, 纳秒
+    uint32_t Warnings; // 可疑操作次数(未知命令、与寻址模式不符的命令)
+} SSD1306_Stats;
+
+extern uint32_t SSD1306_BusHz; // 总线时钟, 默认400kHz
+
+void SSD1306_Reset(void);
+void SSD1306_Write(const uint8_t *Buf, uint16_t Len);
+void SSD1306_GetStats(SSD1306_Stats *Stats);
+void SSD1306_ClearStats(void);
+uint8_t SSD1306_Pixel(uint8_t X, uint8_t Y);
+int SSD1306_DumpPBM(const char *Path);
+int SSD1306_ComparePBM(const char *Path);
+
+#endif
@@ -0,0 +1,205 @@
+#include "stm32f10x.h"
+#include <stdio.h>
+#include "OLED.h"
+#include "MyRTC.h"
+#include "UI.h"
+#include "DS18B20.h"
+#include "SSD1306.h"
+#include "Sim.h"
+
+/*
+ * 画面基准测试: 以固定的时间与状态绘制各界面, 经仿真SSD1306得到屏幕图像,
+ * 导出为PBM基准图像, 或与已有基准逐像素比较, 并报告每帧总线流量.
+ * 部分画面由另一画面切换而来, 用于检查增量刷新后屏幕与整屏重绘一致:
+ * 同一界面内的切换只重绘变化的控件, 不同界面间的切换由UI_Show清屏后重绘.
+ */
+
+extern char Feed_ED;
+extern uint8_t FeedCount;
+extern uint8_t TempValid, TempShow;
+extern int16_t Temperature[];
+extern uint8_t Servoflag, BaitWarning, WiFiState;
+extern uint8_t FeedInterval[3];
+extern uint8_t SetMenu_CurL, SetMenu_CurC;
+extern Calendar_TypeDef TempT;
+extern uint8_t *TempFI;
+extern const UI_Screen UI_MainScreen, UI_SetScreen, UI_DiagScreen;
+
+#define SCREENS_TIME 1704082245 // 2024-01-01 12:10:45(UTC+8)
+
+static uint8_t Interval[3] = {1, 30, 0};
+
+// 各画面从默认状态出发, 只改动与默认不同的状态
+static void Screens_Default(void)
+{
+    Feed_ED = '1';
+    FeedCount = 3;
+    TempValid = 0x01;
+    TempShow = 0;
+    Temperature[0] = 2650;
+    Temperature[1] = 1800;
+    Servoflag = 0;
+    BaitWarning = 0;
+    WiFiState = 0;
+    FeedInterval[0] = Interval[0];
+    FeedInterval[1] = Interval[1];
+    FeedInterval[2] = Interval[2];
+}
+
+static void Draw_Main(void)
+{
+    Screens_Default();
+    UI_Show(&UI_MainScreen);
+    UI_Update();
+}
+
+static void Draw_Feeding(void)
+{
+    Screens_Default();
+    Servoflag = 1;
+    UI_Show(&UI_MainScreen);
+    UI_Update();
+}
+
+static void Draw_Warning(void)
+{
+    Screens_Default();
+    FeedCount = 12;
+    BaitWarning = 1;
+    WiFiState = 1;
+    UI_Show(&UI_MainScreen);
+    UI_Update();
+}
+
+static void Draw_SensorLost(void)
+{
+    Screens_Default();
+    TempValid = 0;
+    UI_Show(&UI_MainScreen);
+    UI_Update();
+}
+
+static void Draw_MultiSensor(void)
+{
+    Screens_Default();
+    TempValid = 0x03;
+    TempShow = 1;
+    UI_Show(&UI_MainScreen);
+    UI_Update();
+}
+
+static void Draw_Set(void)
+{
+    Screens_Default();
+    MyRTC_GetTime(&TempT);
+    TempFI = Interval;
+    SetMenu_CurL = 1;
+    SetMenu_CurC = 112;
+    UI_Show(&UI_SetScreen);
+    UI_Update();
+}
+
+static void Draw_SetInterval(void)
+{
+    Screens_Default();
+    MyRTC_GetTime(&TempT);
+    TempFI = Interval;
+    SetMenu_CurL = 7;
+    SetMenu_CurC = 65;
+    UI_Show(&UI_SetScreen);
+    UI_Update();
+}
+
+static void Draw_Diag(void)
+{
+    static const DS18B20_StatTypeDef Stat = {1234, 7, 42, 9, 1};
+
+    Screens_Default();
+    DS18B20_Stat = Stat;
+    UI_Show(&UI_DiagScreen);
+    UI_Update();
+}
+
+typedef struct
+{
+    const char *Name;   // 基准图像文件名
+    void (*From)(void); // 切换前的画面, NULL表示从清屏开始
+    void (*Draw)(void); // 待检查的画面
+} Screen_TypeDef;
+
+static const Screen_TypeDef Screens[] = {
+    {"main", NULL, Draw_Main},
+    {"feeding", NULL, Draw_Feeding},
+    {"warning", NULL, Draw_Warning},
+    {"sensor_lost", NULL, Draw_SensorLost},
+    {"multi_sensor", NULL, Draw_MultiSensor},
+    {"set", NULL, Draw_Set},
+    {"set_interval", NULL, Draw_SetInterval},
+    {"diag", NULL, Draw_Diag},
+    // 投饵过程中按菜单键进入设置界面, 与直接绘制的设置界面应完全相同
+    {"set", Draw_Feeding, Draw_Set},
+    {"main", Draw_Set, Draw_Main},
+    {"diag", Draw_Main, Draw_Diag},
+    {"main", Draw_Diag, Draw_Main},
+    // 同一界面内状态变化, 只重绘变化的控件
+    {"main", Draw_Feeding, Draw_Main},
+    {"feeding", Draw_Main, Draw_Feeding},
+    {"warning", Draw_Main, Draw_Warning},
+    {"main", Draw_Warning, Draw_Main},
+    {"sensor_lost", Draw_Main, Draw_SensorLost},
+    {"main", Draw_SensorLost, Draw_Main},
+    {"multi_sensor", Draw_Main, Draw_MultiSensor},
+    {"main", Draw_MultiSensor, Draw_Main},
+    {"set_interval", Draw_Set, Draw_SetInterval},
+    {"set", Draw_SetInterval, Draw_Set},
+};
+
+/**
+ * @brief  绘制全部画面并导出或比较基准图像
+ * @param  Dir 基准图像目录
+ * @param  Update 1:导出为新的基准图像 | 0:与基准图像比较
+ * @retval 不一致的画面数
+ */
+int Screens_Run(const char *Dir, int Update)
+{
+    char Path[256];
+    SSD1306_Stats Stats;
+    int Failed = 0, Diff;
+    uint32_t i;
+
+    MyRTC_Init();
+    Sim_RTC_SetCounter(SCREENS_TIME);
+    OLED_Init();
+    Sim_DS18B20_N = 2; // 诊断界面显示已分配编号的传感器数
+    DS18B20_Init();
+
+    printf("%-14s %-10s %7s %8s %6s %9s %6s\n", "screen", "from", "glyphs", "bytes", "trans", "bus(us)", "diff");
+    for (i = 0; i < sizeof(Screens) / sizeof(Screens[0]); i++)
+    {
+        UI_Show(NULL);
+        if (Screens[i].From)
+            Screens[i].From();
+        OLED_RefreshSync();
+
+        SSD1306_ClearStats();
+        UI_Glyphs = 0;
+        Screens[i].Draw();
+        OLED_RefreshSync();
+        SSD1306_GetStats(&Stats);
+
+        snprintf(Path, sizeof(Path), "%s/%s.pbm", Dir, Screens[i].Name);
+        if (Update && !Screens[i].From)
+            SSD1306_DumpPBM(Path);
+        Diff = SSD1306_ComparePBM(Path);
+        if (Diff != 0)
+            Failed++;
+        if (Stats.Warnings)
+            Failed++;
+
+        printf("%-14s %-10s %7u %8u %6u %9.1f %6d%s\n", Screens[i].Name, Screens[i].From ? "switch" : "clear",
+               (unsigned)UI_Glyphs, (unsigned)Stats.Bytes, (unsigned)Stats.Trans, Stats.BusNs / 1000.0, Diff,
+               Stats.Warnings ? "  (bus warnings)" : "");
+    }
+    printf("%s\n", Failed ? "FAIL" : "OK");
+    return Failed;
+}
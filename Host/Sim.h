@@ -0,0 +1,34 @@
+#ifndef __SIM_H
+#define __SIM_H
+
+/*
+ * 主机仿真外设的控制接口, 仅主机构建使用.
+ * 固件代码通过原有模块头文件(Key.h、MyUSART.h、MyRTC.h等)访问外设,
+ * Host/Sim_*.c以相同接口实现这些模块, 本文件提供仿真专用的注入与观测函数.
+ */
+
+// Sim_GPIO.c: 按键、饵料检测、舵机
+extern uint8_t Sim_BaitLow;    // 1:模拟饵料不足
+extern uint8_t Sim_ServoAngle; // 舵机当前角度
+void Sim_KeyPush(uint8_t Event);
+void Sim_KeyStdin(uint8_t Enable);
+
+// Sim_OneWire.c: 单总线上的DS18B20
+#define SIM_DS18B20_MAX 8
+extern float Sim_Temperature[SIM_DS18B20_MAX]; // 各传感器温度, ℃
+extern uint8_t Sim_DS18B20_N;                  // 总线上的传感器数
+extern uint8_t Sim_TempFault;                  // 1:模拟总线断开(无存在脉冲)
+extern uint32_t Sim_OneWireNoise;              // 非0时平均每N个读时隙翻转一个
+extern uint32_t Sim_DS18B20_Conversions;       // 温度转换次数(按器件计)
+extern uint32_t Sim_DS18B20_Copies;            // EEPROM写入次数(按器件计)
+
+// Sim_Store.c: Flash参数存储页
+extern uint32_t Sim_StoreWrites; // 擦写次数
+
+// Sim_USART.c: USART1(ESP8266)
+int Sim_USART_Open(const char *Path);
+
+// Sim_RTC.c: RTC与BKP
+void Sim_RTC_SetCounter(uint32_t Counter);
+
+#endif
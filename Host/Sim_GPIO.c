@@ -0,0 +1,105 @@
+#include "stm32f10x.h"
+#include <stdio.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include "Tick.h"
+#include "Key.h"
+#include "Bait.h"
+#include "Servo.h"
+#include "Sim.h"
+
+/*
+ * GPIO类外设仿真: 按键事件队列、饵料检测(PB1)、舵机(TIM2 PWM). 单总线(PB0)见Sim_OneWire.c.
+ */
+
+#define SIM_KEY_FIFO_LEN 16
+
+uint8_t Sim_BaitLow = 0;
+uint8_t Sim_ServoAngle = 0;
+
+uint32_t Key_Lost = 0;
+
+static uint8_t Sim_KeyFifo[SIM_KEY_FIFO_LEN];
+static uint8_t Sim_KeyIn = 0, Sim_KeyOut = 0;
+static uint8_t Sim_KeyStdinOn = 0;
+
+/**
+ * @brief  注入一个按键事件(同Key_Scan产生的事件格式)
+ * @param  Event 事件类型|键码
+ * @retval 无
+ */
+void Sim_KeyPush(uint8_t Event)
+{
+    if ((uint8_t)(Sim_KeyIn - Sim_KeyOut) >= SIM_KEY_FIFO_LEN)
+    {
+        Key_Lost++;
+        return;
+    }
+    Sim_KeyFifo[Sim_KeyIn++ % SIM_KEY_FIFO_LEN] = Event;
+}
+
+/**
+ * @brief  启用标准输入按键: w上 s下 a左 d右 e菜单/确认 q返回 b切换饵料不足
+ * @param  Enable 1:启用 | 0:关闭
+ * @retval 无
+ */
+void Sim_KeyStdin(uint8_t Enable)
+{
+    Sim_KeyStdinOn = Enable;
+    if (Enable)
+        fcntl(STDIN_FILENO, F_SETFL, fcntl(STDIN_FILENO, F_GETFL) | O_NONBLOCK);
+}
+
+static void Sim_KeyPoll(void)
+{
+    static const char Keys[] = "ewsadq";
+    static const uint8_t Codes[] = {5, 8, 2, 4, 6, 1};
+    char Ch;
+    uint8_t i;
+
+    while (Sim_KeyStdinOn && (read(STDIN_FILENO, &Ch, 1) == 1))
+    {
+        if (Ch == 'b')
+            Sim_BaitLow = !Sim_BaitLow;
+        for (i = 0; i < sizeof(Codes); i++)
+        {
+            if (Ch == Keys[i])
+            {
+                Sim_KeyPush(KEY_PRESS | Codes[i]);
+                Sim_KeyPush(KEY_RELEASE | Codes[i]);
+            }
+        }
+    }
+}
+
+void Key_Init(void)
+{
+}
+
+uint8_t Key_GetEvent(void)
+{
+    Sim_KeyPoll();
+    if (Sim_KeyIn == Sim_KeyOut)
+        return 0;
+    return Sim_KeyFifo[Sim_KeyOut++ % SIM_KEY_FIFO_LEN];
+}
+
+void Bait_Init(void)
+{
+}
+
+uint8_t Bait_Low(void)
+{
+    return Sim_BaitLow;
+}
+
+void Servo_Init(void)
+{
+}
+
+void Servo_SetAngle(uint8_t Angle)
+{
+    if (Angle != Sim_ServoAngle)
+        fprintf(stderr, "[%u ms] servo %u\n", (unsigned)Tick_Get(), Angle);
+    Sim_ServoAngle = Angle;
+}
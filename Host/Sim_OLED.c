@@ -0,0 +1,66 @@
+#include "stm32f10x.h"
+#include <string.h>
+#include "OLED.h"
+#include "SSD1306.h"
+
+/*
+ * OLED总线仿真: 每次传输立即完成, 由SSD1306.c解码并维护屏幕内容.
+ * 窗口写入完成后随即启动下一页, 同板上I2C1事件中断在停止信号后启动下一页.
+ * OLED_BusBytes/OLED_BusTrans口径同板上OLED_BUS_STAT: 每次传输计从机地址与控制字节各1字节.
+ */
+
+uint32_t OLED_BusBytes = 0;
+uint32_t OLED_BusTrans = 0;
+
+static void Sim_OLED_Transfer(uint8_t Control, const uint8_t *Data, uint16_t Len)
+{
+    static uint8_t Buf[1 + 8 * 128];
+
+    if (Len > sizeof(Buf) - 1)
+        Len = sizeof(Buf) - 1;
+    Buf[0] = Control;
+    memcpy(Buf + 1, Data, Len);
+    SSD1306_Write(Buf, Len + 1);
+
+    OLED_BusTrans++;
+    OLED_BusBytes += 2 + Len;
+}
+
+void OLED_Bus_Init(void)
+{
+    SSD1306_Reset();
+}
+
+void OLED_WriteCommands(const uint8_t *Command, uint8_t Len)
+{
+    Sim_OLED_Transfer(0x00, Command, Len);
+}
+
+void OLED_WriteDataStream(const uint8_t *Data, uint16_t Len)
+{
+    Sim_OLED_Transfer(0x40, Data, Len);
+}
+
+uint8_t OLED_WriteWindowDMA(uint8_t Line, uint8_t Column, const uint8_t *Data, uint8_t Len)
+{
+    static const uint8_t Prefix[] = {0x80, 0x21, 0x80, 0, 0x80, 127, 0x80, 0x22, 0x80, 0, 0x80, 7, 0x40};
+    uint8_t Buf[sizeof(Prefix) + 128];
+
+    memcpy(Buf, Prefix, sizeof(Prefix));
+    Buf[3] = Column;
+    Buf[9] = Line;
+    memcpy(Buf + sizeof(Prefix), Data, Len);
+    SSD1306_Write(Buf, sizeof(Prefix) + Len);
+    OLED_BusTrans++;
+    OLED_BusBytes += 1 + sizeof(Prefix) + Len;
+
+#if OLED_TRANSPORT == OLED_TRANSPORT_I2C1
+    OLED_RefreshNext(0);
+#endif
+    return 0;
+}
+
+uint8_t OLED_Busy(void)
+{
+    return 0;
+}
@@ -0,0 +1,338 @@
+#include "stm32f10x.h"
+#include <stdlib.h>
+#include <string.h>
+#include "Tick.h"
+#include "Delay.h"
+#include "OneWire.h"
+#include "Sim.h"
+
+/*
+ * 单总线(PB0)仿真: 总线上挂接Sim_DS18B20_N个DS18B20, 在位时隙层面实现各器件的ROM命令
+ * (搜索ROM、匹配ROM、跳过ROM、读ROM)与功能命令(温度转换、读/写暂存器、复制暂存器到EEPROM),
+ * 每个时隙的总线电平为主机写入的位与各器件输出的线与. 固件的DS18B20.c在主机上原样运行.
+ * 转换时间随配置寄存器中的分辨率变化, 取数据手册最长时间的80%(实际器件通常早于最长时间完成),
+ * 结果按分辨率截去无定义的低位. Sim_OneWireNoise非0时按该比例随机翻转读时隙的结果, 模拟中断打断位时隙.
+ */
+
+// 器件状态
+#define SIM_OW_IDLE 0   // 未被选中, 等待复位
+#define SIM_OW_ROM 1    // 接收ROM命令
+#define SIM_OW_MATCH 2  // 匹配ROM: 逐位比较主机写入的编码
+#define SIM_OW_SEARCH 3 // 搜索ROM
+#define SIM_OW_FUNC 4   // 接收功能命令
+#define SIM_OW_SEND 5   // 输出数据(读ROM、读暂存器)
+#define SIM_OW_CONV 6   // 温度转换或复制暂存器, 读时隙应答完成状态
+#define SIM_OW_WRITE 7  // 写暂存器: 接收TH、TL、配置寄存器
+
+float Sim_Temperature[SIM_DS18B20_MAX] = {25.0f, 22.5f, 19.0f, 27.25f, 24.0f, 23.0f, 21.5f, 20.0f};
+uint8_t Sim_DS18B20_N = 1;
+uint8_t Sim_TempFault = 0;
+uint32_t Sim_OneWireNoise = 0;
+
+typedef struct
+{
+    uint8_t Rom[8];
+    uint8_t Scratchpad[9];
+    uint8_t State;
+    uint8_t Byte, BitN;  // 正在接收的字节与已收位数
+    uint8_t Step;        // 搜索ROM: 0读位 1读反码 2写方向
+    const uint8_t *Out;  // 输出数据
+    uint8_t OutBits;     // 已输出位数
+    uint8_t OutLen;      // 输出字节数
+    uint8_t Eeprom[3];   // EEPROM中的TH、TL、配置寄存器, 上电时载入暂存器
+    uint32_t ConvTick;   // 转换(或复制)启动时刻
+    uint32_t ConvTime;   // 转换(或复制)耗时, 毫秒
+    uint8_t Converting;  // 1:温度转换中 | 2:复制暂存器中
+} Sim_DS18B20;
+
+uint32_t Sim_DS18B20_Conversions = 0; // 温度转换次数(按器件计)
+uint32_t Sim_DS18B20_Copies = 0;      // EEPROM写入次数(按器件计)
+
+static Sim_DS18B20 Sim_Dev[SIM_DS18B20_MAX];
+static uint8_t Sim_Ready = 0;
+static uint32_t Sim_TouchEnd; // 异步传输结束时刻, 周期
+
+static uint8_t Sim_CRC8(const uint8_t *Data, uint8_t Len)
+{
+    uint8_t CRC8 = 0, i;
+    while (Len--)
+    {
+        CRC8 ^= *Data++;
+        for (i = 0; i < 8; i++)
+            CRC8 = (CRC8 & 0x01) ? (CRC8 >> 1) ^ 0x8C : CRC8 >> 1;
+    }
+    return CRC8;
+}
+
+static uint8_t Sim_RomBit(const Sim_DS18B20 *D, uint8_t i)
+{
+    return (D->Rom[i / 8] >> (i % 8)) & 0x01;
+}
+
+/**
+ * @brief  转换完成时把温度写入暂存器
+ */
+static void Sim_Latch(Sim_DS18B20 *D, uint8_t i)
+{
+    int16_t Raw;
+    uint8_t Bits = 9 + ((D->Scratchpad[4] >> 5) & 0x03);
+
+    if (!D->Converting || (Tick_Get() - D->ConvTick < D->ConvTime))
+        return;
+    if (D->Converting == 2) // 复制暂存器
+    {
+        memcpy(D->Eeprom, &D->Scratchpad[2], 3);
+        D->Converting = 0;
+        return;
+    }
+    D->Converting = 0;
+    Raw = (int16_t)(Sim_Temperature[i] * 16 + (Sim_Temperature[i] >= 0 ? 0.5f : -0.5f));
+    Raw &= ~((1 << (12 - Bits)) - 1);
+    D->Scratchpad[0] = Raw & 0xFF;
+    D->Scratchpad[1] = (Raw >> 8) & 0xFF;
+    D->Scratchpad[8] = Sim_CRC8(D->Scratchpad, 8);
+}
+
+static void Sim_Setup(void)
+{
+    static const uint8_t Scratchpad[8] = {0x50, 0x05, 0x4B, 0x46, 0x7F, 0xFF, 0x0C, 0x10}; // 上电值85℃, 12位
+    uint8_t i;
+
+    if (Sim_Ready)
+        return;
+    Sim_Ready = 1;
+    for (i = 0; i < SIM_DS18B20_MAX; i++)
+    {
+        uint8_t Rom[8] = {0x28, 0x10 + 0x21 * i, 0x5E, 0xA1 ^ i, 0x0B, 0x16, 0x00};
+        Rom[7] = Sim_CRC8(Rom, 7);
+        memcpy(Sim_Dev[i].Rom, Rom, 8);
+        memcpy(Sim_Dev[i].Scratchpad, Scratchpad, 8);
+        memcpy(Sim_Dev[i].Eeprom, &Scratchpad[2], 3);
+        Sim_Dev[i].Scratchpad[8] = Sim_CRC8(Scratchpad, 8);
+    }
+}
+
+/**
+ * @brief  器件收到一个完整字节
+ */
+static void Sim_Command(Sim_DS18B20 *D, uint8_t i)
+{
+    if (D->State == SIM_OW_ROM)
+    {
+        switch (D->Byte)
+        {
+        case 0xCC: // 跳过ROM
+            D->State = SIM_OW_FUNC;
+            break;
+        case 0x55: // 匹配ROM
+            D->State = SIM_OW_MATCH;
+            break;
+        case 0xF0: // 搜索ROM
+            D->State = SIM_OW_SEARCH;
+            D->Step = 0;
+            break;
+        case 0x33: // 读ROM
+            D->State = SIM_OW_SEND;
+            D->Out = D->Rom;
+            D->OutLen = 8;
+            D->OutBits = 0;
+            break;
+        default:
+            D->State = SIM_OW_IDLE;
+        }
+    }
+    else if (D->State == SIM_OW_FUNC)
+    {
+        switch (D->Byte)
+        {
+        case 0x44: // 温度转换
+            D->State = SIM_OW_CONV;
+            D->ConvTick = Tick_Get();
+            D->ConvTime = (750 >> (3 - ((D->Scratchpad[4] >> 5) & 0x03))) * 4 / 5;
+            D->Converting = 1;
+            Sim_DS18B20_Conversions++;
+            break;
+        case 0x4E: // 写暂存器
+            D->State = SIM_OW_WRITE;
+            D->OutBits = 0;
+            break;
+        case 0x48: // 复制暂存器到EEPROM
+            D->State = SIM_OW_CONV;
+            D->ConvTick = Tick_Get();
+            D->ConvTime = 10;
+            D->Converting = 2;
+            Sim_DS18B20_Copies++;
+            break;
+        case 0xBE: // 读暂存器
+            Sim_Latch(D, i);
+            D->State = SIM_OW_SEND;
+            D->Out = D->Scratchpad;
+            D->OutLen = 9;
+            D->OutBits = 0;
+            break;
+        default:
+            D->State = SIM_OW_IDLE;
+        }
+    }
+    else if (D->State == SIM_OW_WRITE)
+    {
+        D->Scratchpad[2 + D->OutBits] = D->Byte;
+        if (D->OutBits == 2)
+            D->Scratchpad[4] = (D->Byte & 0x60) | 0x1F;
+        D->Scratchpad[8] = Sim_CRC8(D->Scratchpad, 8);
+        if (++D->OutBits == 3)
+            D->State = SIM_OW_IDLE;
+    }
+    D->BitN = 0;
+}
+
+void OneWire_Init(void)
+{
+    Sim_Setup();
+}
+
+uint8_t OneWire_Reset(void)
+{
+    uint8_t i;
+
+    Sim_Setup();
+    if (Sim_TempFault || (Sim_DS18B20_N == 0))
+        return 1;
+    for (i = 0; i < Sim_DS18B20_N; i++)
+    {
+        Sim_Latch(&Sim_Dev[i], i);
+        Sim_Dev[i].State = SIM_OW_ROM;
+        Sim_Dev[i].BitN = 0;
+    }
+    return 0;
+}
+
+/**
+ * @brief  一个时隙: 处于接收状态的器件收下主机写入的位, 处于输出状态的器件输出一位,
+ *         总线电平为主机写入的位与各器件输出的线与(写1的时隙即读时隙)
+ */
+static uint8_t Sim_Slot(uint8_t Bit)
+{
+    Sim_DS18B20 *D;
+    uint8_t i, Line = Bit;
+
+    if (Sim_TempFault)
+        return Bit;
+    for (i = 0; i < Sim_DS18B20_N; i++)
+    {
+        D = &Sim_Dev[i];
+        switch (D->State)
+        {
+        case SIM_OW_ROM:
+        case SIM_OW_FUNC:
+        case SIM_OW_WRITE:
+            D->Byte = (D->Byte >> 1) | (Bit ? 0x80 : 0);
+            if (++D->BitN == 8)
+                Sim_Command(D, i);
+            break;
+        case SIM_OW_MATCH:
+            if (Sim_RomBit(D, D->BitN) != Bit)
+                D->State = SIM_OW_IDLE;
+            else if (++D->BitN == 64)
+            {
+                D->State = SIM_OW_FUNC;
+                D->BitN = 0;
+            }
+            break;
+        case SIM_OW_SEARCH:
+            if (D->Step == 0)
+                Line &= Sim_RomBit(D, D->BitN);
+            else if (D->Step == 1)
+                Line &= !Sim_RomBit(D, D->BitN);
+            else if (Sim_RomBit(D, D->BitN) != Bit)
+                D->State = SIM_OW_IDLE;
+            else if (++D->BitN == 64)
+            {
+                D->State = SIM_OW_FUNC;
+                D->BitN = 0;
+            }
+            D->Step = (D->Step + 1) % 3;
+            break;
+        case SIM_OW_SEND:
+            if (D->OutBits < D->OutLen * 8)
+            {
+                Line &= (D->Out[D->OutBits / 8] >> (D->OutBits % 8)) & 0x01;
+                D->OutBits++;
+            }
+            break;
+        case SIM_OW_CONV:
+            Sim_Latch(D, i);
+            Line &= !D->Converting;
+            break;
+        }
+    }
+    if (Bit && Sim_OneWireNoise && (rand() % Sim_OneWireNoise == 0))
+        Line = !Line;
+    return Line;
+}
+
+void OneWire_WriteBit(uint8_t Bit)
+{
+    Sim_Slot(Bit ? 1 : 0);
+}
+
+uint8_t OneWire_ReadBit(void)
+{
+    return Sim_Slot(1);
+}
+
+uint8_t OneWire_Touch(uint8_t *Data, uint8_t Len)
+{
+    uint8_t i, j, Byte;
+
+    for (i = 0; i < Len; i++)
+    {
+        Byte = 0;
+        for (j = 0; j < 8; j++)
+            if (Sim_Slot((Data[i] >> j) & 0x01))
+                Byte |= 1 << j;
+        Data[i] = Byte;
+    }
+    return 0;
+}
+
+/**
+ * @brief  异步传输: 时隙在启动时即完成, 按USART2方式每时隙87us计的传输时间到达后OneWire_TouchDone才返回1
+ */
+void OneWire_TouchStart(uint8_t *Data, uint8_t Len)
+{
+    OneWire_Touch(Data, Len);
+    Sim_TouchEnd = Delay_GetCycle() + Len * 8u * 87u * 72u;
+}
+
+uint8_t OneWire_TouchDone(void)
+{
+    return (int32_t)(Delay_GetCycle() - Sim_TouchEnd) >= 0;
+}
+
+uint8_t OneWire_TouchEnd(void)
+{
+    return 0;
+}
+
+void OneWire_WriteByte(uint8_t Data)
+{
+    uint8_t i;
+    for (i = 0; i < 8; i++)
+    {
+        OneWire_WriteBit(Data & 0x01);
+        Data >>= 1;
+    }
+}
+
+uint8_t OneWire_ReadByte(void)
+{
+    uint8_t i, Data = 0;
+    for (i = 0; i < 8; i++)
+    {
+        Data >>= 1;
+        if (OneWire_ReadBit())
+            Data |= 0x80;
+    }
+    return Data;
+}
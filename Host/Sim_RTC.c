@@ -0,0 +1,152 @@
+#include "stm32f10x.h"
+#include <stdio.h>
+#include <time.h>
+#include "Tick.h"
+#include "MyRTC.h"
+#include "Sim.h"
+
+/*
+ * RTC与BKP仿真: RTC计数值为UTC秒数(同板上约定, 显示时加UTC偏移),
+ * 从启动时的系统时间开始随Tick_Get递增; BKP寄存器保存在内存中.
+ * 闹钟与秒中断都没有中断: 闹钟在MyRTC_GetAlarm查询时判断是否到时, 投饵时刻的排定与板上相同;
+ * 本地时间缓存在MyRTC_GetTime读取时按计数值的变化补做秒中断的更新(与板上相同, 用Calendar.c换算).
+ * 网络校时只调整计数值并在标准错误输出偏差, 不仿真晶振误差与校准.
+ * BKP不跨进程保存, 不仿真断电期间错过投饵的补投.
+ */
+
+static uint32_t Sim_RTC_Base;     // Tick为0时对应的RTC计数值
+static uint16_t Sim_BKP[3];       // BKP_DR2~DR4: 投饵间隔 时 分 秒
+static uint32_t Sim_Period;       // 投饵间隔, 秒
+static uint32_t Sim_Next;         // 下一个投饵时刻(BKP_DR9~DR10)
+static uint8_t Sim_AlarmOn = 0;
+
+static Calendar_TypeDef Sim_Now;                  // 本地时间缓存
+static uint32_t Sim_Local = 0;                    // Sim_Now对应的本地秒数
+static int16_t Sim_Offset = MYRTC_OFFSET_DEFAULT; // UTC偏移, 分钟(BKP_DR5)
+
+static uint32_t Sim_RTC_GetCounter(void)
+{
+    return Sim_RTC_Base + Tick_Get() / 1000;
+}
+
+/**
+ * @brief  设置RTC计数值(UTC秒数)
+ * @param  Counter 计数值
+ * @retval 无
+ */
+void Sim_RTC_SetCounter(uint32_t Counter)
+{
+    Sim_RTC_Base = Counter - Tick_Get() / 1000;
+}
+
+/**
+ * @brief  按计数值更新本地时间缓存, 同板上秒中断
+ * @param  无
+ * @retval 无
+ */
+static void Sim_RTC_Update(void)
+{
+    uint32_t Local = Sim_RTC_GetCounter() + Sim_Offset * 60;
+
+    if (Local == Sim_Local)
+        return;
+    if (Local == Sim_Local + 1)
+        Calendar_NextSecond(&Sim_Now);
+    else
+        Calendar_FromSeconds(Local, &Sim_Now);
+    Sim_Local = Local;
+}
+
+/**
+ * @brief  设定下一个投饵时刻, 与板上MyRTC_Schedule同用Calendar_NextDeadline
+ * @param  Next 下一个投饵时刻, UTC秒数
+ * @param  Now 判断是否错过所依据的时刻
+ * @retval 无
+ */
+static void Sim_RTC_Schedule(uint32_t Next, uint32_t Now)
+{
+    Sim_Next = Calendar_NextDeadline(Next, Now, Sim_Period, Sim_Offset * 60 - MYRTC_FEED_PHASE);
+}
+
+void MyRTC_Init(void)
+{
+    Sim_RTC_SetCounter((uint32_t)time(NULL));
+    Sim_RTC_Update();
+}
+
+void MyRTC_SetTime(const Calendar_TypeDef *Time)
+{
+    Sim_RTC_SetCounter(Calendar_ToSeconds(Time) - Sim_Offset * 60);
+    Sim_RTC_Update();
+}
+
+void MyRTC_GetTime(Calendar_TypeDef *Time)
+{
+    Sim_RTC_Update();
+    *Time = Sim_Now;
+}
+
+void MyRTC_SetOffset(int16_t Minutes)
+{
+    Sim_Offset = Minutes;
+    Sim_RTC_Update();
+    if (Sim_AlarmOn)
+        Sim_RTC_Schedule(Sim_Next, Sim_RTC_GetCounter());
+}
+
+int16_t MyRTC_GetOffset(void)
+{
+    return Sim_Offset;
+}
+
+void MyRTC_Sync(uint32_t Utc)
+{
+    uint32_t Counter = Sim_RTC_GetCounter();
+    int32_t Err = Counter - Utc;
+
+    fprintf(stderr, "[%u ms] rtc sync %+d s\n", (unsigned)Tick_Get(), (int)Err);
+    if ((Err >= -1) && (Err <= 1))
+        return;
+    Sim_RTC_SetCounter(Utc);
+    if (Sim_AlarmOn)
+        Sim_RTC_Schedule(Sim_Next, (Err > 0) ? Counter : Utc);
+    Sim_RTC_Update();
+}
+
+void MyRTC_SetAlarm(uint8_t *Interval)
+{
+    Interval[0] = Sim_BKP[0];
+    Interval[1] = Sim_BKP[1];
+    Interval[2] = Sim_BKP[2];
+
+    Sim_Period = Interval[0] * 60 * 60 + Interval[1] * 60 + Interval[2];
+    if (Sim_Period)
+    {
+        Sim_RTC_Schedule(Sim_AlarmOn ? Sim_Next : 0, Sim_RTC_GetCounter());
+        Sim_AlarmOn = 1;
+    }
+    else
+    {
+        Sim_AlarmOn = 0;
+    }
+}
+
+void MyRTC_AlarmOff(void)
+{
+    Sim_AlarmOn = 0;
+}
+
+uint8_t MyRTC_GetAlarm(void)
+{
+    if (!Sim_AlarmOn || (Sim_RTC_GetCounter() < Sim_Next))
+        return 0;
+    Sim_RTC_Schedule(Sim_Next + Sim_Period, Sim_RTC_GetCounter());
+    return 1;
+}
+
+void MyRTC_SaveInterval(uint8_t *Interval)
+{
+    Sim_BKP[0] = Interval[0];
+    Sim_BKP[1] = Interval[1];
+    Sim_BKP[2] = Interval[2];
+}
@@ -0,0 +1,29 @@
+#include "stm32f10x.h"
+#include <string.h>
+#include "Store.h"
+
+/*
+ * 参数存储仿真: Flash存储页保存在内存中, 程序退出后丢失.
+ */
+
+static uint8_t Sim_StorePage[STORE_SIZE];
+static uint16_t Sim_StoreLen = 0; // 已保存记录的长度, 0表示无记录
+uint32_t Sim_StoreWrites = 0;     // 擦写次数
+
+uint8_t Store_Load(void *Data, uint16_t Len)
+{
+    if ((Sim_StoreLen == 0) || (Sim_StoreLen != Len))
+        return 1;
+    memcpy(Data, Sim_StorePage, Len);
+    return 0;
+}
+
+uint8_t Store_Save(const void *Data, uint16_t Len)
+{
+    if (Len > STORE_SIZE - 6)
+        return 1;
+    memcpy(Sim_StorePage, Data, Len);
+    Sim_StoreLen = Len;
+    Sim_StoreWrites++;
+    return 0;
+}
@@ -0,0 +1,62 @@
+#include "stm32f10x.h"
+#include <time.h>
+#include "Tick.h"
+#include "Delay.h"
+
+/*
+ * 时间基准仿真: SysTick毫秒时基与DWT周期计数均由CLOCK_MONOTONIC换算,
+ * 周期数按72MHz HCLK折算, 便于与板上Delay_GetCycle测得的数值对照.
+ */
+
+static struct timespec Sim_Start;
+static uint8_t Sim_Started = 0;
+
+static uint64_t Sim_Nanos(void)
+{
+    struct timespec Now;
+
+    if (!Sim_Started)
+    {
+        clock_gettime(CLOCK_MONOTONIC, &Sim_Start);
+        Sim_Started = 1;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &Now);
+    return (uint64_t)(Now.tv_sec - Sim_Start.tv_sec) * 1000000000ull + Now.tv_nsec - Sim_Start.tv_nsec;
+}
+
+void Tick_Init(void)
+{
+    Sim_Nanos();
+}
+
+uint32_t Tick_Get(void)
+{
+    return (uint32_t)(Sim_Nanos() / 1000000);
+}
+
+void Delay_Init(void)
+{
+    Tick_Init();
+}
+
+uint32_t Delay_GetCycle(void)
+{
+    return (uint32_t)(Sim_Nanos() * 72 / 1000);
+}
+
+void Delay_us(uint32_t xus)
+{
+    struct timespec Ts = {xus / 1000000, (xus % 1000000) * 1000};
+    nanosleep(&Ts, NULL);
+}
+
+void Delay_ms(uint32_t xms)
+{
+    Delay_us(xms * 1000);
+}
+
+void Delay_s(uint32_t xs)
+{
+    while (xs--)
+        Delay_ms(1000);
+}
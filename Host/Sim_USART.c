@@ -0,0 +1,108 @@
+#include "stm32f10x.h"
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <termios.h>
+#include "MyUSART.h"
+#include "Sim.h"
+
+/*
+ * USART1仿真: 收发经由一个文件描述符(串口设备、伪终端等),
+ * 未打开时相当于ESP8266未连接, 发送的数据被丢弃, 收不到任何应答.
+ * 发送同步完成, 完成回调在MyUSART_Write返回前调用.
+ */
+
+uint32_t MyUSART_RxLost = 0;
+
+static int Sim_USART_Fd = -1;
+static char RECS[256];
+static uint16_t RECS_Len = 0;
+
+/**
+ * @brief  打开ESP8266所连接的设备
+ * @param  Path 设备路径
+ * @retval 0:成功 | -1:失败
+ */
+int Sim_USART_Open(const char *Path)
+{
+    struct termios Tio;
+
+    Sim_USART_Fd = open(Path, O_RDWR | O_NOCTTY | O_NONBLOCK);
+    if (Sim_USART_Fd < 0)
+        return -1;
+    // 串口或伪终端: 原始模式, 115200 8N1(同板上USART1)
+    if (tcgetattr(Sim_USART_Fd, &Tio) == 0)
+    {
+        cfmakeraw(&Tio);
+        cfsetspeed(&Tio, B115200);
+        tcsetattr(Sim_USART_Fd, TCSANOW, &Tio);
+    }
+    return 0;
+}
+
+void MyUSART_Init(void)
+{
+}
+
+char *MyUSART_GetString(void)
+{
+    return RECS;
+}
+
+char *MyUSART_GetLine(void)
+{
+    char Ch;
+
+    while ((Sim_USART_Fd >= 0) && (read(Sim_USART_Fd, &Ch, 1) == 1))
+    {
+        if (Ch == '\n')
+        {
+            if ((RECS_Len > 0) && (RECS[RECS_Len - 1] == '\r'))
+                RECS_Len--;
+            RECS[RECS_Len] = '\0';
+            RECS_Len = 0;
+            return RECS;
+        }
+        if (RECS_Len < sizeof(RECS) - 1)
+            RECS[RECS_Len++] = Ch;
+        else
+            MyUSART_RxLost++;
+    }
+    return NULL;
+}
+
+uint8_t MyUSART_Write(const uint8_t *Data, uint16_t Len, MyUSART_Callback Done)
+{
+    ssize_t n;
+
+    while ((Sim_USART_Fd >= 0) && Len)
+    {
+        n = write(Sim_USART_Fd, Data, Len);
+        if (n <= 0)
+        {
+            usleep(100);
+            continue;
+        }
+        Data += n;
+        Len -= n;
+    }
+    if (Done)
+        Done();
+    return 0;
+}
+
+uint8_t MyUSART_TxBusy(void)
+{
+    return 0;
+}
+
+void MyUSART_SendString(char *str)
+{
+    MyUSART_Write((const uint8_t *)str, strlen(str), NULL);
+}
+
+void MyUSART_Put(const char *Data, uint16_t Len)
+{
+    MyUSART_Write((const uint8_t *)Data, Len, NULL);
+}
@@ -0,0 +1,12 @@
+/**
+ * 主机构建用的stm32f10x.h替身.
+ * 固件逻辑代码(界面、任务调度、AT命令、解析)只需要基本整数类型,
+ * 不包含任何外设定义: 误用外设寄存器或库函数的代码在主机构建时直接编译失败.
+ */
+#ifndef __STM32F10x_H
+#define __STM32F10x_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#endif
@@ -0,0 +1,120 @@
+#include "stm32f10x.h" // Device header
+#include "Calendar.h"
+
+#define CALENDAR_DAYS_0000_1970 719468 // 0000-03-01至1970-01-01的天数
+
+static const uint8_t Calendar_MonthDays[12] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+
+/**
+ * @brief  计算指定年月的天数
+ * @param  Year 年
+ * @param  Month 月, 1 - 12
+ * @retval 天数, 28 - 31
+ */
+static uint8_t Calendar_DaysInMonth(uint16_t Year, uint8_t Month)
+{
+    if ((Month == 2) && ((Year % 4 == 0) && ((Year % 100 != 0) || (Year % 400 == 0))))
+        return 29;
+    return Calendar_MonthDays[Month - 1];
+}
+
+/**
+ * @brief  计算日期距1970-01-01的天数
+ * @param  Year 年, 1970 - 2106
+ * @param  Month 月, 1 - 12
+ * @param  Day 日, 1 - 31
+ * @retval 天数
+ */
+uint32_t Calendar_DaysFromCivil(uint16_t Year, uint8_t Month, uint8_t Day)
+{
+    uint32_t Era, Yoe, Doy;
+
+    if (Month <= 2) // 1、2月归入上一年
+        Year--;
+    Era = Year / 400;
+    Yoe = Year - Era * 400;                                            // 400年周期内的年, 0 - 399
+    Doy = (153 * (Month > 2 ? Month - 3 : Month + 9) + 2) / 5 + Day - 1; // 自3月1日起的天数, 0 - 365
+    return Era * 146097 + Yoe * 365 + Yoe / 4 - Yoe / 100 + Doy - CALENDAR_DAYS_0000_1970;
+}
+
+/**
+ * @brief  由秒数计算日期与时间
+ * @param  Seconds 1970-01-01 00:00:00起的秒数
+ * @param  Time 日期与时间
+ * @retval 无
+ */
+void Calendar_FromSeconds(uint32_t Seconds, Calendar_TypeDef *Time)
+{
+    uint32_t Days = Seconds / 86400, Sec = Seconds % 86400;
+    uint32_t Era, Doe, Yoe, Doy, Mp, Year;
+
+    Time->Hour = Sec / 3600;
+    Time->Minute = Sec / 60 % 60;
+    Time->Second = Sec % 60;
+    Time->Week = (Days + 4) % 7; // 1970-01-01为星期四
+
+    Days += CALENDAR_DAYS_0000_1970;
+    Era = Days / 146097;
+    Doe = Days - Era * 146097;                                   // 400年周期内的天, 0 - 146096
+    Yoe = (Doe - Doe / 1460 + Doe / 36524 - Doe / 146096) / 365; // 0 - 399
+    Year = Yoe + Era * 400;
+    Doy = Doe - (365 * Yoe + Yoe / 4 - Yoe / 100);
+    Mp = (5 * Doy + 2) / 153; // 自3月起的月, 0 - 11
+    Time->Day = Doy - (153 * Mp + 2) / 5 + 1;
+    Time->Month = (Mp < 10) ? Mp + 3 : Mp - 9;
+    Time->Year = Year + (Time->Month <= 2);
+}
+
+/**
+ * @brief  由日期与时间计算秒数(Week不参与计算)
+ * @param  Time 日期与时间
+ * @retval 1970-01-01 00:00:00起的秒数
+ */
+uint32_t Calendar_ToSeconds(const Calendar_TypeDef *Time)
+{
+    return Calendar_DaysFromCivil(Time->Year, Time->Month, Time->Day) * 86400 +
+           Time->Hour * 3600 + Time->Minute * 60 + Time->Second;
+}
+
+/**
+ * @brief  日期与时间前进一秒, 逐级进位, 绝大多数情况只改动秒
+ * @param  Time 日期与时间
+ * @retval 无
+ */
+void Calendar_NextSecond(Calendar_TypeDef *Time)
+{
+    if (++Time->Second < 60)
+        return;
+    Time->Second = 0;
+    if (++Time->Minute < 60)
+        return;
+    Time->Minute = 0;
+    if (++Time->Hour < 24)
+        return;
+    Time->Hour = 0;
+    Time->Week = (Time->Week + 1) % 7;
+    if (++Time->Day <= Calendar_DaysInMonth(Time->Year, Time->Month))
+        return;
+    Time->Day = 1;
+    if (++Time->Month <= 12)
+        return;
+    Time->Month = 1;
+    Time->Year++;
+}
+
+/**
+ * @brief  周期时刻: 满足(t + Shift) % Period == 0的秒数t, 如Shift取UTC偏移秒数时为本地0点起每隔Period秒.
+ *         Next为周期时刻且在(Now, Now + Period]内时原样返回, 否则(已过、不在周期时刻上或超前一个周期以上)
+ *         返回Now之后的第一个周期时刻. 只做整数运算, 不访问寄存器
+ * @param  Next 预定的时刻, 秒数
+ * @param  Now 当前时刻, 秒数
+ * @param  Period 周期, 秒, 须非0
+ * @param  Shift 周期时刻的平移, 秒, 可为负
+ * @retval 下一个周期时刻
+ */
+uint32_t Calendar_NextDeadline(uint32_t Next, uint32_t Now, uint32_t Period, int32_t Shift)
+{
+    if (((Next + (uint32_t)Shift) % Period != 0) || (Next - Now - 1 >= Period))
+        Next = Now + Period - (Now + (uint32_t)Shift) % Period;
+    return Next;
+}
@@ -0,0 +1,28 @@
+#ifndef __CALENDAR_H
+#define __CALENDAR_H
+
+#include "stm32f10x.h"
+
+/*
+ * 日历换算: 1970-01-01 00:00:00起的秒数与年月日时分秒互换, 只用整数运算, 不依赖time.h.
+ * 年月日与天数的换算采用days-from-civil算法(3月为一年之首, 闰日落在年末), 无需逐年逐月累加.
+ */
+
+typedef struct
+{
+    uint16_t Year;  // 年, 1970 - 2106
+    uint8_t Month;  // 月, 1 - 12
+    uint8_t Day;    // 日, 1 - 31
+    uint8_t Hour;   // 时, 0 - 23
+    uint8_t Minute; // 分, 0 - 59
+    uint8_t Second; // 秒, 0 - 59
+    uint8_t Week;   // 星期, 0 - 6, 0为星期日
+} Calendar_TypeDef;
+
+uint32_t Calendar_DaysFromCivil(uint16_t Year, uint8_t Month, uint8_t Day);
+void Calendar_FromSeconds(uint32_t Seconds, Calendar_TypeDef *Time);
+uint32_t Calendar_ToSeconds(const Calendar_TypeDef *Time);
+void Calendar_NextSecond(Calendar_TypeDef *Time);
+uint32_t Calendar_NextDeadline(uint32_t Next, uint32_t Now, uint32_t Period, int32_t Shift);
+
+#endif
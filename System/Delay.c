@@ -1,30 +1,56 @@
 #include "stm32f10x.h"
+#include "Tick.h"
+#include "Delay.h"
+
+#define DEM_CR			(*(volatile uint32_t *)0xE000EDFC)	//调试异常与监视控制寄存器
+#define DWT_CTRL		(*(volatile uint32_t *)0xE0001000)	//DWT控制寄存器
+#define DEM_CR_TRCENA	(1UL << 24)
+#define DWT_CTRL_CYCCNTENA	(1UL << 0)
+
+/**
+  * @brief  延时初始化，启用DWT时钟周期计数器(微秒延时)及SysTick毫秒时基
+  * @param  无
+  * @retval 无
+  */
+void Delay_Init(void)
+{
+	DEM_CR |= DEM_CR_TRCENA;				//使能DWT
+	DWT_CYCCNT = 0;
+	DWT_CTRL |= DWT_CTRL_CYCCNTENA;			//启动周期计数
+	Tick_Init();
+}
 
 /**
-  * @brief  微秒级延时
-  * @param  xus 延时时长，范围：0~233015
+  * @brief  读取DWT时钟周期计数值，可用于测量代码执行时间
+  * @param  无
+  * @retval 自由运行的HCLK周期计数，约59.6秒回绕一次
+  */
+uint32_t Delay_GetCycle(void)
+{
+	return DWT_CYCCNT;
+}
+
+/**
+  * @brief  微秒级延时，基于DWT周期计数，不占用SysTick
+  * @param  xus 延时时长，范围：0~59652323
   * @retval 无
   */
 void Delay_us(uint32_t xus)
 {
-	SysTick->LOAD = 72 * xus;				//设置定时器重装值
-	SysTick->VAL = 0x00;					//清空当前计数值
-	SysTick->CTRL = 0x00000005;				//设置时钟源为HCLK，启动定时器
-	while(!(SysTick->CTRL & 0x00010000));	//等待计数到0
-	SysTick->CTRL = 0x00000004;				//关闭定时器
+	uint32_t Start = DWT_CYCCNT;
+	uint32_t Cycles = xus * (SystemCoreClock / 1000000);
+	while(DWT_CYCCNT - Start < Cycles);		//差值比较，计数回绕时仍正确
 }
 
 /**
-  * @brief  毫秒级延时
-  * @param  xms 延时时长，范围：0~4294967295
+  * @brief  毫秒级延时，基于SysTick毫秒时基
+  * @param  xms 延时时长，范围：0~2147483647
   * @retval 无
   */
 void Delay_ms(uint32_t xms)
 {
-	while(xms--)
-	{
-		Delay_us(1000);
-	}
+	uint32_t Start = Tick_Get();
+	while(Tick_Get() - Start < xms);
 }
  
 /**
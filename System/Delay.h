@@ -1,6 +1,10 @@
 #ifndef __DELAY_H
 #define __DELAY_H
 
+#define DWT_CYCCNT		(*(volatile uint32_t *)0xE0001004)	//DWT时钟周期计数器, 需要内联计时处可直接读取
+
+void Delay_Init(void);
+uint32_t Delay_GetCycle(void);
 void Delay_us(uint32_t us);
 void Delay_ms(uint32_t ms);
 void Delay_s(uint32_t s);
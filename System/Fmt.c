@@ -0,0 +1,181 @@
+#include "stm32f10x.h" // Device header
+#include <string.h>
+#include "Fmt.h"
+
+#define FMT_DIGITS_MAX 10 // uint32_t十进制最多位数
+
+/**
+ * @brief  开始一次格式化输出
+ * @param  F 格式化状态
+ * @param  Buf 输出缓冲区
+ * @param  Size 缓冲区大小, 字节. 无Flush时须留出结尾'\0'的位置
+ * @param  Flush 缓冲区满时的输出函数, NULL表示超出部分截断
+ * @retval 无
+ */
+void Fmt_Init(Fmt_TypeDef *F, char *Buf, uint16_t Size, Fmt_FlushFunc Flush)
+{
+    F->Buf = Buf;
+    F->Size = Size;
+    F->Len = 0;
+    F->Over = 0;
+    F->Flush = Flush;
+}
+
+/**
+ * @brief  追加一段字符, 缓冲区满时交给Flush或截断
+ * @param  F 格式化状态
+ * @param  Data 字符
+ * @param  Len 字符数
+ * @retval 无
+ */
+static void Fmt_Put(Fmt_TypeDef *F, const char *Data, uint16_t Len)
+{
+    int32_t Room;
+
+    while (Len)
+    {
+        Room = (int32_t)F->Size - F->Len - (F->Flush ? 0 : 1); // 无Flush时保留结尾'\0'
+        if (Room <= 0)
+        {
+            if ((F->Flush == 0) || (F->Len == 0))
+            {
+                F->Over = 1;
+                return;
+            }
+            F->Flush(F->Buf, F->Len);
+            F->Len = 0;
+            continue;
+        }
+        if (Room > Len)
+            Room = Len;
+        memcpy(F->Buf + F->Len, Data, Room);
+        F->Len += Room;
+        Data += Room;
+        Len -= Room;
+    }
+}
+
+/**
+ * @brief  追加一个字符
+ * @param  F 格式化状态
+ * @param  Ch 字符
+ * @retval 无
+ */
+void Fmt_Char(Fmt_TypeDef *F, char Ch)
+{
+    Fmt_Put(F, &Ch, 1);
+}
+
+/**
+ * @brief  追加字符串
+ * @param  F 格式化状态
+ * @param  Str 以'\0'结尾的字符串
+ * @retval 无
+ */
+void Fmt_Str(Fmt_TypeDef *F, const char *Str)
+{
+    Fmt_Put(F, Str, strlen(Str));
+}
+
+/**
+ * @brief  追加字符串, 按AT命令字符串参数的规则转义: '"'、','、'\'前加'\'.
+ *         不需转义的连续字符整段复制
+ * @param  F 格式化状态
+ * @param  Str 以'\0'结尾的字符串
+ * @retval 无
+ */
+void Fmt_Esc(Fmt_TypeDef *F, const char *Str)
+{
+    char Esc[2] = {'\\', 0};
+    const char *Run;
+
+    while (*Str)
+    {
+        Run = Str;
+        while (*Str && (*Str != '"') && (*Str != ',') && (*Str != '\\'))
+            Str++;
+        Fmt_Put(F, Run, Str - Run);
+        if (*Str)
+        {
+            Esc[1] = *Str++;
+            Fmt_Put(F, Esc, 2);
+        }
+    }
+}
+
+/**
+ * @brief  追加无符号十进制整数, 数字由低位向高位逐位求出(每位一次除法), 整段写入
+ * @param  F 格式化状态
+ * @param  Value 数值
+ * @param  Width 最少位数, 不足补0; 0与1相同
+ *     @arg 取值: 0 - 10
+ * @retval 无
+ */
+void Fmt_Uint(Fmt_TypeDef *F, uint32_t Value, uint8_t Width)
+{
+    char Text[FMT_DIGITS_MAX];
+    uint8_t n = sizeof(Text);
+
+    do
+    {
+        Text[--n] = '0' + Value % 10;
+        Value /= 10;
+    } while ((Value || (sizeof(Text) - n < Width)) && n);
+    Fmt_Put(F, Text + n, sizeof(Text) - n);
+}
+
+/**
+ * @brief  追加有符号十进制整数, 负数带'-'
+ * @param  F 格式化状态
+ * @param  Value 数值
+ * @retval 无
+ */
+void Fmt_Int(Fmt_TypeDef *F, int32_t Value)
+{
+    Fmt_Fixed(F, Value, 0);
+}
+
+/**
+ * @brief  追加有符号定点小数, 如Declen为2时-305输出为"-3.05"
+ * @param  F 格式化状态
+ * @param  Value 实际值乘以10的Declen次方
+ * @param  Declen 小数位数, 0时与Fmt_Int相同
+ *     @arg 取值: 0 - 9
+ * @retval 无
+ */
+void Fmt_Fixed(Fmt_TypeDef *F, int32_t Value, uint8_t Declen)
+{
+    char Text[FMT_DIGITS_MAX + 2]; // 数字、小数点与负号
+    uint32_t Abs = (Value < 0) ? -(uint32_t)Value : (uint32_t)Value;
+    uint8_t n = sizeof(Text), Digits = 0;
+
+    do
+    {
+        if (Declen && (Digits == Declen))
+            Text[--n] = '.';
+        Text[--n] = '0' + Abs % 10;
+        Abs /= 10;
+        Digits++;
+    } while ((Abs || (Digits <= Declen)) && (Digits < FMT_DIGITS_MAX));
+    if (Value < 0)
+        Text[--n] = '-';
+    Fmt_Put(F, Text + n, sizeof(Text) - n);
+}
+
+/**
+ * @brief  结束格式化输出: 有Flush时交出缓冲区中剩余的字符, 否则在末尾写入'\0'
+ * @param  F 格式化状态
+ * @retval 1:输出被截断 | 0:完整
+ */
+uint8_t Fmt_End(Fmt_TypeDef *F)
+{
+    if (F->Flush)
+    {
+        if (F->Len)
+            F->Flush(F->Buf, F->Len);
+        F->Len = 0;
+    }
+    else if (F->Size)
+        F->Buf[F->Len] = '\0';
+    return F->Over;
+}
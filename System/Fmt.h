@@ -0,0 +1,32 @@
+#ifndef __FMT_H
+#define __FMT_H
+
+#include "stm32f10x.h"
+
+/*
+ * 轻量格式化输出, 替代sprintf/printf: 逐项追加整数、定点小数与字符串, 不解析格式串.
+ * 输出写入调用者提供的缓冲区; 给出Flush时缓冲区写满即交给Flush(如串口发送队列)后继续写入.
+ * 状态全部在Fmt_TypeDef中, 可重入; 任何情况下都不会写出缓冲区.
+ */
+
+typedef void (*Fmt_FlushFunc)(const char *Data, uint16_t Len);
+
+typedef struct
+{
+    char *Buf;           // 输出缓冲区
+    uint16_t Size;       // 缓冲区大小, 字节
+    uint16_t Len;        // 缓冲区中已写入的字符数
+    uint8_t Over;        // 截断标志: 无Flush且缓冲区已满, 其后的字符被丢弃
+    Fmt_FlushFunc Flush; // 缓冲区满时的输出函数, NULL表示截断
+} Fmt_TypeDef;
+
+void Fmt_Init(Fmt_TypeDef *F, char *Buf, uint16_t Size, Fmt_FlushFunc Flush);
+void Fmt_Char(Fmt_TypeDef *F, char Ch);
+void Fmt_Str(Fmt_TypeDef *F, const char *Str);
+void Fmt_Esc(Fmt_TypeDef *F, const char *Str);
+void Fmt_Uint(Fmt_TypeDef *F, uint32_t Value, uint8_t Width);
+void Fmt_Int(Fmt_TypeDef *F, int32_t Value);
+void Fmt_Fixed(Fmt_TypeDef *F, int32_t Value, uint8_t Declen);
+uint8_t Fmt_End(Fmt_TypeDef *F);
+
+#endif
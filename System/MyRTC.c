@@ -1,7 +1,71 @@
 #include "stm32f10x.h" // Device header
-#include <time.h>
+#include "MyRTC.h"
 
-void MyRTC_SetTime(uint16_t *MyRTC_Time);
+/*
+ * RTC计数值为UTC秒数, 显示用的本地时间为计数值加UTC偏移.
+ * 本地时间缓存在MyRTC_Now中, 由秒中断逐秒进位更新(计数值不连续时整体重算), 读取时间只需复制结构体.
+ *
+ * 网络校时(MyRTC_Sync): 以网络时间为准, 偏差超过1秒时调整计数值.
+ * 两次调整之间RTC累计的偏差即LSE晶振的频率误差, 据此修正RTC校准值(MyRTC_Calib),
+ * 使断网期间走时误差也保持在每天1秒以内. 校准值单位为每2^20个时钟周期1个周期(约0.954ppm):
+ * 正值由BKP_RTCCR减慢RTC(至多127); 负值时分频系数改为32767使RTC加快32个单位, 再由BKP_RTCCR减慢.
+ * 上次调整时的网络时间保存在BKP_DR6(低16位)、BKP_DR7(高16位), 校准值保存在BKP_DR8.
+ *
+ * 自动投饵: 投饵时刻固定为本地时间 0点 + MYRTC_FEED_PHASE + k×投饵间隔, 闹钟到时后由上一个投饵时刻
+ * 加一个间隔得到下一个, 不以到时或投饵结束的时刻为起点, 投饵耗时与中断延迟不会累积.
+ * 下一个投饵时刻(UTC秒数)保存在BKP_DR9(低16位)、BKP_DR10(高16位), 闹钟关闭时清0;
+ * 上电时该时刻已过即为断电期间错过了投饵, 按MYRTC_CATCHUP补投或跳过.
+ */
+
+static volatile uint8_t MyRTC_Alarm = 0; // 闹钟到时标志, 由闹钟中断置位
+
+static Calendar_TypeDef MyRTC_Now;                  // 当前本地时间
+static uint32_t MyRTC_Local;                        // MyRTC_Now对应的本地秒数
+static volatile uint32_t MyRTC_Seq = 0;             // MyRTC_Now更新次数, 读取期间发生变化则重读
+static int16_t MyRTC_Offset = MYRTC_OFFSET_DEFAULT; // UTC偏移, 分钟
+static int16_t MyRTC_Calib = 0;                     // RTC校准值, 单位2^-20(约0.954ppm), 正值减慢RTC
+static uint32_t MyRTC_Period = 0;                   // 投饵间隔, 秒
+static uint32_t MyRTC_Next;                         // 下一个投饵时刻, UTC秒数
+
+/**
+ * @brief  按RTC计数值更新本地时间缓存: 比上次恰好多一秒时逐级进位, 否则整体重算.
+ *         在秒中断内调用; 主循环中调用须关中断
+ * @param  无
+ * @retval 无
+ */
+static void MyRTC_Update(void)
+{
+    uint32_t Local = RTC_GetCounter() + MyRTC_Offset * 60;
+
+    if (Local == MyRTC_Local)
+        return;
+    if (Local == MyRTC_Local + 1)
+        Calendar_NextSecond(&MyRTC_Now);
+    else
+        Calendar_FromSeconds(Local, &MyRTC_Now);
+    MyRTC_Local = Local;
+    MyRTC_Seq++;
+}
+
+/**
+ * @brief  设定下一个投饵时刻并写入闹钟. Next不在投饵时刻上(间隔或UTC偏移已改变)或不在
+ *         (Now, Now+间隔]内(已错过或时间被调回)时, 改用Now之后的第一个投饵时刻(见Calendar_NextDeadline).
+ *         MyRTC_Period须非0; 在闹钟中断内调用, 主循环中调用须关中断
+ * @param  Next 下一个投饵时刻, UTC秒数
+ * @param  Now 判断是否错过所依据的时刻, 通常为当前计数值
+ * @retval 无
+ */
+static void MyRTC_Schedule(uint32_t Next, uint32_t Now)
+{
+    Next = Calendar_NextDeadline(Next, Now, MyRTC_Period, MyRTC_Offset * 60 - MYRTC_FEED_PHASE);
+    MyRTC_Next = Next;
+    BKP_WriteBackupRegister(BKP_DR9, Next & 0xFFFF);
+    BKP_WriteBackupRegister(BKP_DR10, Next >> 16);
+
+    RTC_WaitForLastTask();
+    RTC_SetAlarm(Next - 1); // 计数值由ALR变为ALR+1时产生闹钟, 即在Next秒开始时到时
+    RTC_WaitForLastTask();
+}
 
 /**
  * @brief  RTC初始化, 默认时间:2024.1.1 00:00:00
@@ -17,7 +81,7 @@ void MyRTC_Init(void)
 
     if (BKP_ReadBackupRegister(BKP_DR1) != 0xFEFE) // BKP_DR1寄存器内无标记值(VBAT断电), 执行RTC初始化
     {
-        uint16_t Default_Time[] = {2024, 1, 1, 0, 0, 0};
+        const Calendar_TypeDef Default_Time = {2024, 1, 1, 0, 0, 0, 1}; // 星期一
 
         RCC_LSEConfig(RCC_LSE_ON);
         while (RCC_GetFlagStatus(RCC_FLAG_LSERDY) != SET)
@@ -31,7 +95,7 @@ void MyRTC_Init(void)
         RTC_SetPrescaler(32768 - 1);
         RTC_WaitForLastTask();
 
-        MyRTC_SetTime(Default_Time);
+        MyRTC_SetTime(&Default_Time);
 
         BKP_WriteBackupRegister(BKP_DR1, 0xFEFE);
     }
@@ -41,6 +105,17 @@ void MyRTC_Init(void)
         RTC_WaitForLastTask();
     }
 
+    if (BKP_ReadBackupRegister(BKP_DR5) != 0) // 0表示未设置(含旧版本程序写入的备份域)
+        MyRTC_Offset = (int16_t)(BKP_ReadBackupRegister(BKP_DR5) - MYRTC_OFFSET_BIAS);
+    MyRTC_Calib = (int16_t)BKP_ReadBackupRegister(BKP_DR8); // 分频系数与BKP_RTCCR在备份域中, 无需重新写入
+    MyRTC_Next = BKP_ReadBackupRegister(BKP_DR9) | ((uint32_t)BKP_ReadBackupRegister(BKP_DR10) << 16);
+#if MYRTC_CATCHUP == MYRTC_CATCHUP_ONCE
+    if ((MyRTC_Next != 0) && (MyRTC_Next <= RTC_GetCounter())) // 断电时闹钟开启且其后错过了投饵时刻
+        MyRTC_Alarm = 1;
+#endif
+    MyRTC_Local = RTC_GetCounter() + MyRTC_Offset * 60;
+    Calendar_FromSeconds(MyRTC_Local, &MyRTC_Now);
+
     RTC_ITConfig(RTC_IT_SEC,ENABLE); // 使能RTC秒中断
 
     // 配置RTC中断
@@ -61,82 +136,217 @@ void MyRTC_Init(void)
 
 /**
  * @brief  设置RTC时间
- * @param  MyRTC_Time 时间值数组首地址, 长度:6, 0:年 | 1:月 | 2:日 | 3:时 | 4:分 | 5:秒
+ * @param  Time 本地时间(Week不用)
  * @retval 无
  */
-void MyRTC_SetTime(uint16_t *MyRTC_Time)
+void MyRTC_SetTime(const Calendar_TypeDef *Time)
 {
-    time_t time_cnt;
-    struct tm time_date;
+    RTC_SetCounter(Calendar_ToSeconds(Time) - MyRTC_Offset * 60);
+    RTC_WaitForLastTask();
 
-    time_date.tm_year = MyRTC_Time[0] - 1900;
-    time_date.tm_mon = MyRTC_Time[1] - 1;
-    time_date.tm_mday = MyRTC_Time[2];
-    time_date.tm_hour = MyRTC_Time[3];
-    time_date.tm_min = MyRTC_Time[4];
-    time_date.tm_sec = MyRTC_Time[5];
+    __disable_irq();
+    MyRTC_Update();
+    __enable_irq();
 
-    time_cnt = mktime(&time_date) - 8 * 60 * 60;
+    // 手动设置的时间不能作为测量晶振误差的起点
+    BKP_WriteBackupRegister(BKP_DR6, 0);
+    BKP_WriteBackupRegister(BKP_DR7, 0);
+}
 
-    RTC_SetCounter(time_cnt);
+/**
+ * @brief  写入RTC校准值: 设置分频系数与BKP_RTCCR, 并保存到BKP寄存器8
+ * @param  Calib 校准值, 单位2^-20, 正值减慢RTC
+ *     @arg 取值: MYRTC_CALIB_MIN - MYRTC_CALIB_MAX, 超出时取边界值
+ * @retval 无
+ */
+static void MyRTC_SetCalib(int32_t Calib)
+{
+    if (Calib > MYRTC_CALIB_MAX)
+        Calib = MYRTC_CALIB_MAX;
+    if (Calib < MYRTC_CALIB_MIN)
+        Calib = MYRTC_CALIB_MIN;
+    MyRTC_Calib = Calib;
+
+    RTC_WaitForLastTask();
+    if (Calib >= 0)
+    {
+        RTC_SetPrescaler(32768 - 1);
+        BKP_SetRTCCalibrationValue(Calib);
+    }
+    else
+    {
+        RTC_SetPrescaler(32767 - 1); // 加快1/32767, 即32个单位
+        BKP_SetRTCCalibrationValue(Calib + 32);
+    }
     RTC_WaitForLastTask();
+    BKP_WriteBackupRegister(BKP_DR8, (uint16_t)MyRTC_Calib);
 }
 
 /**
- * @brief  读取RTC时间
+ * @brief  以网络时间校准RTC: 偏差超过1秒时调整计数值(投饵时刻不变, 调整越过的投饵时刻跳过, 已到过的不重复),
+ *         并按自上次调整以来的累计偏差修正校准值; 偏差在1秒以内时不调整,
+ *         但距上次调整已满MYRTC_CALIB_PERIOD时仍调整一次, 以修正更小的频率误差
+ * @param  Utc 网络时间, UTC秒数
+ * @retval 无
+ */
+void MyRTC_Sync(uint32_t Utc)
+{
+    uint32_t Counter = RTC_GetCounter();
+    uint32_t Ref = BKP_ReadBackupRegister(BKP_DR6) | ((uint32_t)BKP_ReadBackupRegister(BKP_DR7) << 16);
+    uint32_t Elapsed = Utc - Ref;
+    int32_t Err = Counter - Utc; // RTC超前的秒数
+    int32_t Delta;
+
+    if ((Ref != 0) && (Utc > Ref))
+    {
+        if ((Err >= -1) && (Err <= 1) && (Elapsed < MYRTC_CALIB_PERIOD))
+            return;
+        // 测量时长足够且偏差在晶振误差范围内(而非此前时间就不准)时修正校准值
+        if ((Elapsed >= MYRTC_CALIB_MIN_TIME) && (Err >= -MYRTC_CALIB_ERR_MAX) && (Err <= MYRTC_CALIB_ERR_MAX))
+        {
+            Delta = Err * 1048576 / (int32_t)Elapsed;
+            if ((Delta >= MYRTC_CALIB_MIN - MYRTC_CALIB_MAX) && (Delta <= MYRTC_CALIB_MAX - MYRTC_CALIB_MIN))
+                MyRTC_SetCalib(MyRTC_Calib + Delta);
+        }
+    }
+
+    __disable_irq();
+    RTC_SetCounter(Utc);
+    RTC_WaitForLastTask();
+    if (RTC->CRH & RTC_IT_ALR) // 调快时越过的投饵时刻跳过; 调回时调整前已到过的投饵时刻不再重复
+        MyRTC_Schedule(MyRTC_Next, (Err > 0) ? Counter : Utc);
+    MyRTC_Update();
+    __enable_irq();
+
+    BKP_WriteBackupRegister(BKP_DR6, Utc & 0xFFFF);
+    BKP_WriteBackupRegister(BKP_DR7, Utc >> 16);
+}
+
+/**
+ * @brief  读取当前本地时间, 复制秒中断维护的缓存, 不做换算
+ * @param  Time 本地时间
+ * @retval 无
+ */
+void MyRTC_GetTime(Calendar_TypeDef *Time)
+{
+    uint32_t Seq;
+
+    do
+    {
+        Seq = MyRTC_Seq;
+        *Time = MyRTC_Now;
+    } while (Seq != MyRTC_Seq); // 复制期间秒中断更新了缓存
+}
+
+/**
+ * @brief  设置UTC偏移并保存到BKP寄存器5(VBAT供电时掉电保持). RTC计数值(UTC)不变, 本地时间随之改变;
+ *         闹钟开启时投饵时刻随之对齐到新的本地时间
+ * @param  Minutes 本地时间与UTC之差, 分钟, 如北京时间为480
+ *     @arg 取值: -720 - +840
+ * @retval 无
+ */
+void MyRTC_SetOffset(int16_t Minutes)
+{
+    BKP_WriteBackupRegister(BKP_DR5, (uint16_t)(Minutes + MYRTC_OFFSET_BIAS));
+    __disable_irq();
+    MyRTC_Offset = Minutes;
+    MyRTC_Update();
+    if (RTC->CRH & RTC_IT_ALR)
+        MyRTC_Schedule(MyRTC_Next, RTC_GetCounter());
+    __enable_irq();
+}
+
+/**
+ * @brief  读取UTC偏移
  * @param  无
- * @retval 时间值数组首地址, 长度:6, 0:年 | 1:月 | 2:日 | 3:时 | 4:分 | 5:秒
+ * @retval 本地时间与UTC之差, 分钟
  */
-uint16_t *MyRTC_ReadTime(void)
+int16_t MyRTC_GetOffset(void)
 {
-    time_t time_cnt;
-    struct tm time_date;
-    static uint16_t Read_Time[6];
+    return MyRTC_Offset;
+}
 
-    time_cnt = RTC_GetCounter() + 8 * 60 * 60;
+/**
+ * @brief  读取投饵间隔时间并开启RTC闹钟.
+ *         从BKP寄存器2、3、4读取投饵间隔时间并转换成秒, 闹钟设在保存的下一个投饵时刻;
+ *         该时刻已过、不在当前间隔与UTC偏移的投饵时刻上或闹钟原先关闭时, 改设为当前时刻之后的第一个投饵时刻.
+ *         间隔为0时关闭闹钟
+ * @param  Interval 返回读取的投饵间隔, 数组, 0:时 | 1:分 | 2:秒
+ * @retval 无
+ */
+void MyRTC_SetAlarm(uint8_t *Interval)
+{
+    Interval[0] = BKP_ReadBackupRegister(BKP_DR2);
+    Interval[1] = BKP_ReadBackupRegister(BKP_DR3);
+    Interval[2] = BKP_ReadBackupRegister(BKP_DR4);
 
-    time_date = *localtime(&time_cnt);
+    __disable_irq();
+    MyRTC_Period = Interval[0] * 60 * 60 + Interval[1] * 60 + Interval[2];
+    if (MyRTC_Period)
+    {
+        MyRTC_Schedule(BKP_ReadBackupRegister(BKP_DR9) | ((uint32_t)BKP_ReadBackupRegister(BKP_DR10) << 16),
+                       RTC_GetCounter());
+        RTC_ITConfig(RTC_IT_ALR, ENABLE);
+    }
+    else
+    {
+        MyRTC_AlarmOff();
+    }
+    __enable_irq();
+}
 
-    Read_Time[0] = time_date.tm_year + 1900;
-    Read_Time[1] = time_date.tm_mon + 1;
-    Read_Time[2] = time_date.tm_mday;
-    Read_Time[3] = time_date.tm_hour;
-    Read_Time[4] = time_date.tm_min;
-    Read_Time[5] = time_date.tm_sec;
+/**
+ * @brief  关闭RTC闹钟中断(停止自动投饵), 调用MyRTC_SetAlarm重新开启
+ * @param  无
+ * @retval 无
+ */
+void MyRTC_AlarmOff(void)
+{
+    RTC_ITConfig(RTC_IT_ALR, DISABLE);
+    BKP_WriteBackupRegister(BKP_DR9, 0); // 关闭期间的投饵时刻不算错过
+    BKP_WriteBackupRegister(BKP_DR10, 0);
+}
 
-    return Read_Time;
+/**
+ * @brief  查询并清除闹钟到时标志
+ * @param  无
+ * @retval 1:上次查询后闹钟到时 | 0:未到时
+ */
+uint8_t MyRTC_GetAlarm(void)
+{
+    if (!MyRTC_Alarm)
+        return 0;
+    MyRTC_Alarm = 0;
+    return 1;
 }
 
+/**
+ * @brief  将投饵间隔保存到BKP寄存器2、3、4(VBAT供电时掉电保持)
+ * @param  Interval 投饵间隔, 数组, 0:时 | 1:分 | 2:秒
+ * @retval 无
+ */
+void MyRTC_SaveInterval(uint8_t *Interval)
+{
+    BKP_WriteBackupRegister(BKP_DR2, Interval[0]);
+    BKP_WriteBackupRegister(BKP_DR3, Interval[1]);
+    BKP_WriteBackupRegister(BKP_DR4, Interval[2]);
+}
 
+// RTC中断
+void RTC_IRQHandler(void)
+{
+    // 闹钟中断
+    if (RTC_GetITStatus(RTC_IT_ALR) != RESET)
+    {
+        MyRTC_Alarm = 1;
+        RTC_ClearITPendingBit(RTC_IT_ALR);
+        MyRTC_Schedule(MyRTC_Next + MyRTC_Period, RTC_GetCounter()); // 由本次投饵时刻推算下一次, 与中断响应时刻无关
+    }
 
+    // 秒中断: 本地时间进位
+    if (RTC_GetITStatus(RTC_IT_SEC) != RESET)
+        MyRTC_Update();
 
-// 设置RTC闹钟定时 模板
-// void MyRTC_SetAlarm(void)
-// {
-//     uint32_t sec;
-//     // sec = xxx  // 触发下次闹钟中断所间隔的秒数
-//     RTC_EnterConfigMode();
-//     RTC_SetAlarm(RTC_GetCounter() + sec);
-//     RTC_WaitForLastTask();
-//     RTC_ExitConfigMode();
-//     RTC_ITConfig(RTC_IT_ALR, ENABLE);  // 使能RTC闹钟中断
-// }
-
-// RTC中断函数 模板
-// void RTC_IRQHandler(void)
-// {
-//     // 闹钟中断
-//     if (RTC_GetITStatus(RTC_IT_ALR) != RESET)
-//     {
-//         // 此处填写用户代码
-//         RTC_ClearITPendingBit(RTC_IT_ALR);
-//         MyRTC_SetAlarm();  // 中断后重设闹钟定时
-//     }
-//     // 秒中断
-//     if (RTC_GetITStatus(RTC_IT_SEC) != RESET)
-//     {
-//         // 此处填写用户代码
-//     }
-//     RTC_ClearITPendingBit(RTC_IT_SEC | RTC_IT_OW);
-//     RTC_WaitForLastTask();
-// }
+    RTC_ClearITPendingBit(RTC_IT_SEC | RTC_IT_OW);
+    RTC_WaitForLastTask();
+}
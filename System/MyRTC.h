@@ -1,8 +1,40 @@
 #ifndef __MYRTC_H
 #define __MYRTC_H
 
+#include "Calendar.h"
+
+#define MYRTC_OFFSET_DEFAULT (8 * 60) // 默认UTC偏移, 分钟(北京时间)
+#define MYRTC_OFFSET_BIAS 0x1000      // BKP_DR5保存UTC偏移加此值, 使有效值非0
+
+// 网络校时与晶振误差校准
+#define MYRTC_CALIB_MIN (-32)       // 校准值下限, 约-30.5ppm(RTC慢)
+#define MYRTC_CALIB_MAX 127         // 校准值上限, 约121ppm(RTC快)
+#define MYRTC_CALIB_MIN_TIME 21600  // 距上次调整不足此秒数(6小时)时只调整计数值, 不修正校准值
+#define MYRTC_CALIB_PERIOD 259200   // 距上次调整满此秒数(3天)时即使偏差不超过1秒也调整并修正校准值
+#define MYRTC_CALIB_ERR_MAX 2000    // 累计偏差超过此秒数时视为时间原本不准, 不修正校准值(亦保证偏差乘2^20不溢出)
+
+// 自动投饵时刻: 本地时间 0点 + MYRTC_FEED_PHASE + k×投饵间隔. 间隔整除24小时时每天时刻相同, 如间隔1小时即每个整点
+#ifndef MYRTC_FEED_PHASE
+#define MYRTC_FEED_PHASE 0 // 投饵时刻相位, 秒
+#endif
+
+// 断电期间错过投饵时刻的处理方式
+#define MYRTC_CATCHUP_SKIP 0 // 跳过, 从上电后的下一个投饵时刻继续
+#define MYRTC_CATCHUP_ONCE 1 // 上电后补投一次(无论错过几次), 再从下一个投饵时刻继续
+
+#ifndef MYRTC_CATCHUP
+#define MYRTC_CATCHUP MYRTC_CATCHUP_ONCE
+#endif
+
 void MyRTC_Init(void);
-void MyRTC_SetTime(uint16_t *MyRTC_Time);
-uint16_t *MyRTC_ReadTime(void);
+void MyRTC_SetTime(const Calendar_TypeDef *Time);
+void MyRTC_GetTime(Calendar_TypeDef *Time);
+void MyRTC_SetOffset(int16_t Minutes);
+int16_t MyRTC_GetOffset(void);
+void MyRTC_Sync(uint32_t Utc);
+void MyRTC_SetAlarm(uint8_t *Interval);
+void MyRTC_AlarmOff(void);
+uint8_t MyRTC_GetAlarm(void);
+void MyRTC_SaveInterval(uint8_t *Interval);
 
 #endif
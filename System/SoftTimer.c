@@ -0,0 +1,114 @@
+#include "stm32f10x.h" // Device header
+#include "Tick.h"
+#include "SoftTimer.h"
+
+/*
+ * 哈希时间轮: 定时器按到期时刻对槽数取模挂入对应槽的链表.
+ * SoftTimer_Poll每推进1ms只检查一个槽, 槽内到期时刻未到(需再转若干圈)的定时器保持不动.
+ * 回调在SoftTimer_Poll的调用者(主循环)中执行, 不在中断内.
+ * 任务的TASK_DELAY即以任务断点内的单次定时器实现(无回调), 任务等待其Active清零.
+ */
+#define SOFTTIMER_SLOTS 32 // 时间轮槽数, 须为2的幂
+
+static SoftTimer_TypeDef *SoftTimer_Wheel[SOFTTIMER_SLOTS];
+static uint32_t SoftTimer_Now = 0;     // 已处理到的毫秒时刻
+static uint8_t SoftTimer_Started = 0; // 时间轮已与Tick对齐标志
+
+/**
+ * @brief  将定时器挂入其到期时刻对应的槽
+ * @param  Timer 定时器
+ * @retval 无
+ */
+static void SoftTimer_Insert(SoftTimer_TypeDef *Timer)
+{
+    SoftTimer_TypeDef **Slot = &SoftTimer_Wheel[Timer->Expire & (SOFTTIMER_SLOTS - 1)];
+    Timer->Next = *Slot;
+    *Slot = Timer;
+    Timer->Active = 1;
+}
+
+/**
+ * @brief  停止定时器, 未启动的定时器调用无影响
+ * @param  Timer 定时器
+ * @retval 无
+ */
+void SoftTimer_Stop(SoftTimer_TypeDef *Timer)
+{
+    SoftTimer_TypeDef **Link;
+
+    if (!Timer->Active)
+        return;
+    for (Link = &SoftTimer_Wheel[Timer->Expire & (SOFTTIMER_SLOTS - 1)]; *Link; Link = &(*Link)->Next)
+    {
+        if (*Link == Timer)
+        {
+            *Link = Timer->Next;
+            break;
+        }
+    }
+    Timer->Active = 0;
+}
+
+/**
+ * @brief  启动定时器, 已在运行的定时器按新参数重新计时(可在回调中调用)
+ * @param  Timer 定时器, 须为静态或全局变量
+ * @param  Delay 首次到期延时, 毫秒, 最小为1
+ * @param  Period 到期后的重复周期, 毫秒. 0:单次定时
+ * @param  Func 到期回调. 0:无回调, 只以Active清零表示到期(单次定时)
+ * @retval 无
+ */
+void SoftTimer_Start(SoftTimer_TypeDef *Timer, uint32_t Delay, uint32_t Period, SoftTimer_Callback Func)
+{
+    SoftTimer_Stop(Timer);
+    if (!SoftTimer_Started)
+    {
+        SoftTimer_Now = Tick_Get();
+        SoftTimer_Started = 1;
+    }
+    if (Delay == 0)
+        Delay = 1;
+    Timer->Expire = Tick_Get() + Delay;
+    Timer->Period = Period;
+    Timer->Func = Func;
+    SoftTimer_Insert(Timer);
+}
+
+/**
+ * @brief  推进时间轮至当前时刻并执行到期定时器的回调, 在主循环中反复调用
+ * @param  无
+ * @retval 无
+ */
+void SoftTimer_Poll(void)
+{
+    SoftTimer_TypeDef **Link, *Timer;
+    uint32_t Tick = Tick_Get();
+
+    if (!SoftTimer_Started)
+        return;
+
+    while (SoftTimer_Now != Tick)
+    {
+        SoftTimer_Now++;
+        Link = &SoftTimer_Wheel[SoftTimer_Now & (SOFTTIMER_SLOTS - 1)];
+        while (*Link)
+        {
+            Timer = *Link;
+            if (Timer->Expire != SoftTimer_Now)
+            {
+                Link = &Timer->Next;
+                continue;
+            }
+
+            *Link = Timer->Next; // 摘下到期定时器
+            Timer->Active = 0;
+            if (Timer->Period)
+            {
+                Timer->Expire += Timer->Period;
+                SoftTimer_Insert(Timer);
+            }
+            if (Timer->Func)
+                Timer->Func(); // 回调内可能重新启动或停止本定时器, 重新从槽头遍历
+            Link = &SoftTimer_Wheel[SoftTimer_Now & (SOFTTIMER_SLOTS - 1)];
+        }
+    }
+}
@@ -0,0 +1,19 @@
+#ifndef __SOFTTIMER_H
+#define __SOFTTIMER_H
+
+typedef void (*SoftTimer_Callback)(void);
+
+typedef struct SoftTimer
+{
+    struct SoftTimer *Next;  // 同一时间轮槽内的下一个定时器
+    uint32_t Expire;         // 到期时刻, Tick_Get()毫秒数
+    uint32_t Period;         // 周期, 毫秒. 0:单次定时
+    SoftTimer_Callback Func; // 到期回调, 可为0
+    uint8_t Active;          // 运行标志. 1:已启动 | 0:已停止或单次定时已到期
+} SoftTimer_TypeDef;
+
+void SoftTimer_Start(SoftTimer_TypeDef *Timer, uint32_t Delay, uint32_t Period, SoftTimer_Callback Func);
+void SoftTimer_Stop(SoftTimer_TypeDef *Timer);
+void SoftTimer_Poll(void);
+
+#endif
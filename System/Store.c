@@ -0,0 +1,79 @@
+#include "stm32f10x.h" // Device header
+#include <string.h>
+#include "Store.h"
+
+/*
+ * 参数存储: 在Flash最后一页保存一条记录, 掉电不丢失.
+ * 记录格式(半字): 标志STORE_MAGIC, 数据长度, 数据(按半字补齐), 校验和(数据各半字之和).
+ * 擦写一页约需20-40ms且寿命约1万次, 只应在参数改变时调用Store_Save.
+ * 程序代码不得占用本页: 工程的IROM1大小设为0xFC00(63KB), 代码超出时链接失败而不会被本模块擦除.
+ */
+
+/**
+ * @brief  计算数据各半字之和(末尾不足一个半字时高字节补0)
+ * @param  Data 数据
+ * @param  Len 数据长度, 字节
+ * @retval 校验和
+ */
+static uint16_t Store_Sum(const uint8_t *Data, uint16_t Len)
+{
+    uint16_t Sum = 0, i;
+    for (i = 0; i < Len; i += 2)
+        Sum += Data[i] | ((i + 1 < Len) ? (Data[i + 1] << 8) : 0);
+    return Sum;
+}
+
+/**
+ * @brief  读取记录
+ * @param  Data 输出缓冲区
+ * @param  Len 记录长度, 字节, 须与保存时相同
+ * @retval 0:成功 | 1:无有效记录(从未保存、长度不符或校验错误), Data不变
+ */
+uint8_t Store_Load(void *Data, uint16_t Len)
+{
+    const uint16_t *Page = (const uint16_t *)STORE_ADDR;
+    const uint8_t *Body = (const uint8_t *)(Page + 2);
+
+    if ((Page[0] != STORE_MAGIC) || (Page[1] != Len) || (Len > STORE_SIZE - 6))
+        return 1;
+    if (Page[2 + (Len + 1) / 2] != Store_Sum(Body, Len))
+        return 1;
+    memcpy(Data, Body, Len);
+    return 0;
+}
+
+/**
+ * @brief  擦除存储页并写入记录(阻塞, 期间CPU取指暂停)
+ * @param  Data 数据
+ * @param  Len 数据长度, 字节
+ * @retval 0:成功 | 1:擦写失败或校验不符
+ */
+uint8_t Store_Save(const void *Data, uint16_t Len)
+{
+    const uint8_t *Byte = (const uint8_t *)Data;
+    uint32_t Addr = STORE_ADDR;
+    uint16_t i;
+    FLASH_Status Status;
+
+    if (Len > STORE_SIZE - 6)
+        return 1;
+
+    FLASH_Unlock();
+    FLASH_ClearFlag(FLASH_FLAG_EOP | FLASH_FLAG_PGERR | FLASH_FLAG_WRPRTERR);
+    Status = FLASH_ErasePage(STORE_ADDR);
+    if (Status == FLASH_COMPLETE)
+        Status = FLASH_ProgramHalfWord(Addr, STORE_MAGIC);
+    Addr += 2;
+    if (Status == FLASH_COMPLETE)
+        Status = FLASH_ProgramHalfWord(Addr, Len);
+    Addr += 2;
+    for (i = 0; (i < Len) && (Status == FLASH_COMPLETE); i += 2, Addr += 2)
+        Status = FLASH_ProgramHalfWord(Addr, Byte[i] | ((i + 1 < Len) ? (Byte[i + 1] << 8) : 0));
+    if (Status == FLASH_COMPLETE)
+        Status = FLASH_ProgramHalfWord(Addr, Store_Sum(Byte, Len));
+    FLASH_Lock();
+
+    if (Status != FLASH_COMPLETE)
+        return 1;
+    return memcmp((const void *)(STORE_ADDR + 4), Data, Len) ? 1 : 0;
+}
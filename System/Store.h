@@ -0,0 +1,11 @@
+#ifndef __STORE_H
+#define __STORE_H
+
+#define STORE_ADDR 0x0800FC00 // 参数存储页: 片内Flash最后一页(STM32F103C8, 64KB, 每页1KB)
+#define STORE_SIZE 1024       // 页大小, 字节
+#define STORE_MAGIC 0x5AA5    // 有效记录标志
+
+uint8_t Store_Load(void *Data, uint16_t Len);
+uint8_t Store_Save(const void *Data, uint16_t Len);
+
+#endif
@@ -0,0 +1,76 @@
+#include "stm32f10x.h" // Device header
+#include "Tick.h"
+#include "SoftTimer.h"
+#include "Task.h"
+
+#define TASK_MAX 8 // 最多任务数
+
+typedef struct
+{
+    Task_Func Func;   // 任务函数
+    Task_Pt Pt;       // 任务断点
+    uint16_t Period;  // 调度周期, 毫秒
+    uint8_t Priority; // 优先级, 数值越小越优先
+    uint32_t Next;    // 下次调度时刻
+} Task_TypeDef;
+
+static Task_TypeDef Task_List[TASK_MAX]; // 按优先级从高到低排列
+static uint8_t Task_Num = 0;
+
+/**
+ * @brief  添加任务, 应在进入调度循环前调用
+ * @param  Func 任务函数
+ * @param  Period 调度周期, 毫秒. 0:始终就绪, 会使更低优先级的任务得不到运行, 只宜用于最低优先级
+ * @param  Priority 优先级, 数值越小越优先, 同优先级按添加顺序
+ * @retval 0:成功 | 1:任务表已满
+ */
+uint8_t Task_Add(Task_Func Func, uint16_t Period, uint8_t Priority)
+{
+    uint8_t i;
+
+    if (Task_Num >= TASK_MAX)
+        return 1;
+
+    for (i = Task_Num; (i > 0) && (Task_List[i - 1].Priority > Priority); i--)
+        Task_List[i] = Task_List[i - 1];
+
+    Task_List[i].Func = Func;
+    Task_List[i].Pt.Line = 0;
+    Task_List[i].Period = Period;
+    Task_List[i].Priority = Priority;
+    Task_List[i].Next = Tick_Get();
+    Task_Num++;
+    return 0;
+}
+
+/**
+ * @brief  执行一次调度: 推进软件定时器(含各任务TASK_DELAY的定时器), 然后运行优先级最高的一个就绪任务.
+ *         在主循环中反复调用; 每运行一个任务都重新从最高优先级查找,
+ *         因此高优先级任务的等待时间不超过一个任务单次运行的最长时间加其周期
+ * @param  无
+ * @retval 无
+ */
+void Task_Run(void)
+{
+    Task_TypeDef *Task;
+    uint32_t Now;
+    uint8_t i;
+
+    SoftTimer_Poll();
+
+    Now = Tick_Get();
+    for (i = 0; i < Task_Num; i++)
+    {
+        Task = &Task_List[i];
+        if ((int32_t)(Now - Task->Next) < 0)
+            continue;
+
+        // 按固定节拍推进; 落后超过一个周期时(如长时间被占用)不补跑, 直接重新对齐
+        Task->Next += Task->Period;
+        if ((int32_t)(Now - Task->Next) >= 0)
+            Task->Next = Now + Task->Period;
+
+        Task->Func(&Task->Pt);
+        return;
+    }
+}
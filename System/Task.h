@@ -0,0 +1,65 @@
+#ifndef __TASK_H
+#define __TASK_H
+
+#include "Tick.h"
+#include "SoftTimer.h"
+
+/*
+ * 协作式任务: 每个任务是一个断点续行(protothread)函数, 每次被调度时从上次的等待点继续执行,
+ * 条件不满足时立即返回让出CPU. 任务函数内跨等待点使用的局部变量须声明为static.
+ * 任务内不得调用Delay_ms/Delay_s等阻塞函数, 改用TASK_DELAY/TASK_WAIT_UNTIL.
+ */
+typedef struct
+{
+    uint16_t Line;           // 断点所在行号. 0:从头执行
+    SoftTimer_TypeDef Timer; // TASK_DELAY使用的单次定时器
+} Task_Pt;
+
+typedef uint8_t (*Task_Func)(Task_Pt *Pt);
+
+#define TASK_WAITING 0 // 任务在等待点让出
+#define TASK_ENDED 1   // 任务执行到TASK_END, 下次调度从头开始
+
+#define TASK_BEGIN(Pt) \
+    switch ((Pt)->Line) \
+    {                   \
+    case 0:
+
+#define TASK_END(Pt) \
+    }                \
+    (Pt)->Line = 0;  \
+    return TASK_ENDED
+
+// 条件满足前每次调度都在此处返回. 续行点的case标号紧随return, 不会由上一语句落入(-Wimplicit-fallthrough)
+#define TASK_WAIT_UNTIL(Pt, Cond)      \
+    do                                 \
+    {                                  \
+        (Pt)->Line = __LINE__;         \
+        while (!(Cond))                \
+        {                              \
+            return TASK_WAITING;       \
+        case __LINE__:;                \
+        }                              \
+    } while (0)
+
+// 让出一次, 下次调度从此处之后继续
+#define TASK_YIELD(Pt)                 \
+    do                                 \
+    {                                  \
+        (Pt)->Line = __LINE__;         \
+        return TASK_WAITING;           \
+    case __LINE__:;                    \
+    } while (0)
+
+// 等待Ms毫秒, 期间其他任务照常运行. 到期由时间轮(SoftTimer)判定, 在Task_Run中推进
+#define TASK_DELAY(Pt, Ms)                         \
+    do                                             \
+    {                                              \
+        SoftTimer_Start(&(Pt)->Timer, (Ms), 0, 0); \
+        TASK_WAIT_UNTIL(Pt, !(Pt)->Timer.Active);  \
+    } while (0)
+
+uint8_t Task_Add(Task_Func Func, uint16_t Period, uint8_t Priority);
+void Task_Run(void);
+
+#endif
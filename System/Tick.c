@@ -0,0 +1,28 @@
+#include "stm32f10x.h" // Device header
+
+static volatile uint32_t Tick_Count = 0; // 上电以来的毫秒数, 约49.7天回绕一次
+
+/**
+ * @brief  毫秒时基初始化, SysTick每1ms中断一次, 此后SysTick不得再作他用
+ * @param  无
+ * @retval 无
+ */
+void Tick_Init(void)
+{
+	SysTick_Config(SystemCoreClock / 1000);
+}
+
+/**
+ * @brief  读取毫秒时基
+ * @param  无
+ * @retval 上电以来的毫秒数. 比较先后须用差值, 如 (int32_t)(Tick_Get() - Deadline) >= 0
+ */
+uint32_t Tick_Get(void)
+{
+	return Tick_Count;
+}
+
+void SysTick_Handler(void)
+{
+	Tick_Count++;
+}
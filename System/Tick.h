@@ -0,0 +1,7 @@
+#ifndef __TICK_H
+#define __TICK_H
+
+void Tick_Init(void);
+uint32_t Tick_Get(void);
+
+#endif
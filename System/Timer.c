@@ -10,8 +10,8 @@ void Timer_Init(void)
 	TIM_TimeBaseInitStructure.TIM_ClockDivision = TIM_CKD_DIV1;
 	TIM_TimeBaseInitStructure.TIM_CounterMode = TIM_CounterMode_Up;
 	
-	// 定时1秒
-	TIM_TimeBaseInitStructure.TIM_Period = 10000 - 1;
+	// 定时5毫秒(按键扫描周期)
+	TIM_TimeBaseInitStructure.TIM_Period = 50 - 1;
 	TIM_TimeBaseInitStructure.TIM_Prescaler = 7200 - 1;
 	TIM_TimeBaseInitStructure.TIM_RepetitionCounter = 0;
 	
@@ -32,13 +32,4 @@ void Timer_Init(void)
 	TIM_Cmd(TIM3, ENABLE);
 }
 
-/*
-void TIM3_IRQHandler(void)
-{
-	if (TIM_GetITStatus(TIM3, TIM_IT_Update) == SET)
-	{
-		
-		TIM_ClearITPendingBit(TIM3, TIM_IT_Update);
-	}
-}
-*/
+// TIM3_IRQHandler在Hardware/Key.c中实现(按键扫描)
@@ -0,0 +1,220 @@
+#include "stm32f10x.h" // Device header
+#include "OLED.h"
+#include "UI.h"
+
+#define UI_CELL_MAX 16 // 单个控件的最大字符数
+
+static const UI_Screen *UI_Current = 0; // 当前界面
+static int32_t UI_Last[UI_MAX];         // 各控件当前显示的绑定值, UI_HIDE表示未显示
+
+#if UI_STAT
+uint32_t UI_Glyphs = 0;
+#endif
+
+/**
+ * @brief  字符宽度
+ * @param  Cell 字符
+ * @retval 列数
+ */
+static uint8_t UI_Width(uint8_t Cell)
+{
+    return (Cell >= 0x80) ? 16 : 8;
+}
+
+/**
+ * @brief  写入定长十进制数字, 不足补0
+ * @param  Cell 字符缓冲
+ * @param  Value 数值
+ * @param  Digits 位数
+ * @retval 字符个数
+ */
+static uint8_t UI_Digits(uint8_t *Cell, uint32_t Value, uint8_t Digits)
+{
+    uint8_t i = Digits;
+    while (i--)
+    {
+        Cell[i] = '0' + Value % 10;
+        Value /= 10;
+    }
+    return Digits;
+}
+
+/**
+ * @brief  将控件的绑定值展开为字符串
+ * @param  W 控件
+ * @param  Value 绑定值
+ * @param  Cell 字符缓冲, UI_CELL_MAX个
+ * @retval 字符个数, 隐藏时为0
+ */
+static uint8_t UI_Format(const UI_Widget *W, int32_t Value, uint8_t *Cell)
+{
+    const uint8_t *Text;
+    uint8_t n = 0;
+
+    if (Value == UI_HIDE)
+        return 0;
+    switch (W->Type)
+    {
+    case UI_LABEL:
+        Text = W->Text[Value];
+        while (Text && Text[n] && (n < UI_CELL_MAX))
+        {
+            Cell[n] = Text[n];
+            n++;
+        }
+        break;
+    case UI_NUM:
+        n = UI_Digits(Cell, Value, W->Digits);
+        break;
+    case UI_TIME:
+        UI_Digits(Cell, Value / 10000, 2);
+        Cell[2] = ':';
+        UI_Digits(Cell + 3, Value / 100 % 100, 2);
+        Cell[5] = ':';
+        UI_Digits(Cell + 6, Value % 100, 2);
+        n = 8;
+        break;
+    case UI_FIXED:
+        if (Value < 0)
+        {
+            Cell[n++] = '-';
+            n += UI_Digits(Cell + n, -Value / 10, W->Digits - 1);
+            Value = -Value;
+        }
+        else
+            n = UI_Digits(Cell, Value / 10, W->Digits);
+        Cell[n++] = '.';
+        Cell[n++] = '0' + Value % 10;
+        break;
+    }
+    return n;
+}
+
+/**
+ * @brief  绘制一个字符
+ * @param  Line 行
+ * @param  Column 列
+ * @param  Cell 字符
+ * @retval 无
+ */
+static void UI_DrawCell(uint8_t Line, uint8_t Column, uint8_t Cell)
+{
+    if (Cell >= 0x80)
+        OLED_ShowCN(Line, Column, Cell - 0x80);
+    else
+        OLED_ShowChar(Line, Column, Cell, 8);
+#if UI_STAT
+    UI_Glyphs++;
+#endif
+}
+
+/**
+ * @brief  擦除控件原内容中不会被新内容覆盖的部分(尾部或原光标位置)
+ * @param  W 控件
+ * @param  Old 原绑定值
+ * @param  New 新绑定值
+ * @retval 无
+ */
+static void UI_Erase(const UI_Widget *W, int32_t Old, int32_t New)
+{
+    uint8_t Cell[UI_CELL_MAX];
+    uint8_t i, n, OldEnd, NewEnd;
+
+    if (W->Type == UI_CURSOR)
+    {
+        if ((Old != UI_HIDE) && ((New == UI_HIDE) || ((Old & 0xFFFF) != (New & 0xFFFF))))
+            OLED_ClearArea((Old >> 8) & 0xFF, Old & 0xFF, 2, 16);
+        return;
+    }
+
+    OldEnd = NewEnd = W->Column;
+    n = UI_Format(W, Old, Cell);
+    for (i = 0; i < n; i++)
+        OldEnd += UI_Width(Cell[i]);
+    n = UI_Format(W, New, Cell);
+    for (i = 0; i < n; i++)
+        NewEnd += UI_Width(Cell[i]);
+    if (OldEnd > NewEnd)
+        OLED_ClearArea(W->Line, NewEnd, 2, OldEnd - NewEnd);
+}
+
+/**
+ * @brief  绘制控件新内容中与原内容不同的字符
+ * @param  W 控件
+ * @param  Old 原绑定值
+ * @param  New 新绑定值
+ * @retval 无
+ */
+static void UI_Draw(const UI_Widget *W, int32_t Old, int32_t New)
+{
+    uint8_t OldCell[UI_CELL_MAX], NewCell[UI_CELL_MAX];
+    uint8_t i, j = 0, OldN, NewN, ColOld, ColNew;
+
+    if (W->Type == UI_CURSOR)
+    {
+        if (New != UI_HIDE)
+            UI_DrawCell((New >> 8) & 0xFF, New & 0xFF, UI_CN(New >> 16));
+        return;
+    }
+
+    OldN = UI_Format(W, Old, OldCell);
+    NewN = UI_Format(W, New, NewCell);
+    ColOld = ColNew = W->Column;
+    for (i = 0; i < NewN; i++)
+    {
+        // 找到原内容中起始列不小于本字符的字符, 同列同字符则无需重绘
+        while ((j < OldN) && (ColOld < ColNew))
+            ColOld += UI_Width(OldCell[j++]);
+        if (!((j < OldN) && (ColOld == ColNew) && (OldCell[j] == NewCell[i])))
+            UI_DrawCell(W->Line, ColNew, NewCell[i]);
+        ColNew += UI_Width(NewCell[i]);
+    }
+}
+
+/**
+ * @brief  切换到指定界面: 清屏, 全部控件在下一次UI_Update时绘制. 已是当前界面时不做任何事
+ * @param  Screen 界面, NULL表示清屏且不显示任何界面
+ * @retval 无
+ */
+void UI_Show(const UI_Screen *Screen)
+{
+    uint8_t i;
+
+    if (Screen == UI_Current)
+        return;
+    UI_Current = Screen;
+    OLED_Clear();
+    for (i = 0; i < UI_MAX; i++)
+        UI_Last[i] = UI_HIDE;
+}
+
+/**
+ * @brief  更新当前界面: 读取各控件的绑定值, 只重绘发生变化的控件.
+ *         先擦除全部变化控件的多余部分, 再绘制, 使隐藏或缩短的控件不会擦掉同一位置上新出现的控件
+ * @param  无
+ * @retval 无
+ */
+void UI_Update(void)
+{
+    static int32_t Value[UI_MAX];
+    const UI_Widget *W;
+    uint8_t i;
+
+    if (UI_Current == 0)
+        return;
+
+    for (i = 0; i < UI_Current->Count; i++)
+    {
+        W = &UI_Current->Widget[i];
+        Value[i] = W->Get ? W->Get() : 0;
+        if (Value[i] != UI_Last[i])
+            UI_Erase(W, UI_Last[i], Value[i]);
+    }
+    for (i = 0; i < UI_Current->Count; i++)
+    {
+        if (Value[i] == UI_Last[i])
+            continue;
+        UI_Draw(&UI_Current->Widget[i], UI_Last[i], Value[i]);
+        UI_Last[i] = Value[i];
+    }
+}
@@ -0,0 +1,56 @@
+#ifndef __UI_H
+#define __UI_H
+
+#include "stm32f10x.h"
+
+/*
+ * 保留模式界面: 界面由常量控件表描述(存放于Flash), 每个控件绑定一个取值函数.
+ * UI_Update只重绘取值发生变化的控件, 且只重绘与上次显示内容不同的字符;
+ * 静态标签只在进入界面时绘制一次.
+ * 控件高16像素(两页), 内容为一串字符: ASCII字符8列宽(8x16), UI_CN(n)为汉字字模n, 16列宽.
+ */
+
+#define UI_CN(n) (0x80 + (n)) // 汉字字模编号n(OLED_HzK)
+
+#define UI_HIDE ((int32_t)0x80000000) // 绑定值: 隐藏控件(清除其区域)
+
+// 控件类型
+#define UI_LABEL 0  // 文字, 显示Text[绑定值], NULL项为空白
+#define UI_NUM 1    // 整数, Digits位, 不足补0
+#define UI_TIME 2   // 时:分:秒, 绑定值为 时*10000+分*100+秒
+#define UI_FIXED 3  // 一位小数, 绑定值为实际值*10, Digits为整数位数(负数时含负号)
+#define UI_CURSOR 4 // 光标, 绑定值为UI_CURSOR_AT(字模编号, 行, 列), 位置改变时擦除原位置
+
+#define UI_CURSOR_AT(Glyph, Line, Column) (((int32_t)(Glyph) << 16) | ((Line) << 8) | (Column))
+
+typedef struct
+{
+    uint8_t Type;               // 控件类型
+    uint8_t Line;               // 起始行, 1 - 7(光标控件不用)
+    uint8_t Column;             // 起始列, 1 - 128(光标控件不用)
+    uint8_t Digits;             // UI_NUM/UI_FIXED的位数
+    const uint8_t *const *Text; // UI_LABEL各取值对应的文字(以0结尾)
+    int32_t (*Get)(void);       // 绑定值, NULL表示静态控件(取值恒为0)
+} UI_Widget;
+
+typedef struct
+{
+    const UI_Widget *Widget; // 控件表, 按绘制顺序排列
+    uint8_t Count;           // 控件个数
+} UI_Screen;
+
+#define UI_MAX 16 // 单个界面的最大控件数
+
+// 绘制统计开关. 1:统计UI_Glyphs | 0:不统计
+#ifndef UI_STAT
+#define UI_STAT 0
+#endif
+
+#if UI_STAT
+extern uint32_t UI_Glyphs; // 已绘制的字符(含汉字)数
+#endif
+
+void UI_Show(const UI_Screen *Screen);
+void UI_Update(void);
+
+#endif
@@ -4,12 +4,16 @@
 #include "OLED.h"
 #include "DS18B20.h"
 #include "string.h"
-#include "servo.h"
+#include "Servo.h"
 #include "MyRTC.h"
 #include "MyUSART.h"
 #include "esp.h"
+#include "Tick.h"
+#include "Task.h"
+#include "Bait.h"
+#include "UI.h"
 
-uint8_t UIpage = 0;      // 显示界面标志. 0:主界面 | 1:设置界面
+uint8_t UIpage = 0;      // 显示界面标志. 0:主界面 | 1:设置界面 | 2:诊断界面
 uint8_t BaitWarning = 0; // 饵料余量标志. 0:充足 | 1:不足
 uint8_t WiFiState = 0;   // 网络连接状态标志. 0:已连接 | 1:未连接
 uint8_t TempEnable = 0;  // 温度传感器使能标志. 0:启用 | 1:禁用
@@ -18,342 +22,474 @@ char Feed_ED = '1';      // 自动投饵使能状态标志. '0':禁用 | '1':启
 
 uint8_t FeedInterval[3]; // 投饵间隔.  0:时 | 1:分 | 2:秒
 uint8_t FeedCount = 0;   // 投饵计次
-float Temperature = 0;   // 温度
+int16_t Temperature[DS18B20_MAX]; // 各传感器温度(最近一次转换结果), 0.01℃
+uint8_t TempValid = 0;            // 各传感器读数有效标志, 第i位对应i号传感器. 0:断开或未安装 | 1:正常
+uint8_t TempShow = 0;             // 主界面显示的传感器编号
+uint8_t TempPrecise = 0;          // 全分辨率转换请求. 1:请求中(网络任务置位, 传感器任务完成一次12位转换后清零)
 
 // "设置"界面的光标位置
 uint8_t SetMenu_CurL, SetMenu_CurC;
 
-uint8_t Tuplaod = 0; // 上传数据标志
+// "设置"界面的编辑数据
+Calendar_TypeDef TempT; // 系统时间临时变量
+uint32_t TTT;           // 用于判断处于设置界面时系统时间是否被更改
+uint8_t *TempFI;        // 投饵间隔临时变量. 0:时 | 1:分 | 2:秒
 
 /**
- * @brief  读取投饵间隔时间并设置RTC闹钟.
- *         从BKP寄存器2、3、4读取投饵间隔时间并转换成秒, 设定RTC闹钟
- * @param  无
- * @retval 无
+ * @brief  传感器任务: 周期性向全部传感器广播温度转换, 查询到转换完成(或已过该分辨率的最长转换时间)时逐个读取结果,
+ *         结果缓存在Temperature中供界面显示与数据上传使用.
+ *         分辨率按用途选择: 主界面显示温度时以10位(0.25℃, 至多188ms)每0.5秒采样一次;
+ *         设置界面或网络任务请求上传数据(TempPrecise)时以12位(0.0625℃, 至多750ms)每秒采样一次.
+ *         有传感器读取失败时至多每分钟重新搜索一次总线, 以发现重新接好或新换上的传感器.
+ *         每次调度至多进行一次读暂存器传输或一步搜索, 不长时间占用CPU
+ * @param  Pt 任务断点
+ * @retval TASK_WAITING | TASK_ENDED
  */
-void MyRTC_SetAlarm(void)
+uint8_t Task_Sensor(Task_Pt *Pt)
 {
-    uint32_t FIsec; // 投饵间隔秒数
-    FeedInterval[0] = BKP_ReadBackupRegister(BKP_DR2);
-    FeedInterval[1] = BKP_ReadBackupRegister(BKP_DR3);
-    FeedInterval[2] = BKP_ReadBackupRegister(BKP_DR4);
-
-    FIsec = FeedInterval[0] * 60 * 60 + FeedInterval[1] * 60 + FeedInterval[2] - 1;
+    static uint32_t StartTick;    // 本次转换启动时刻, 毫秒
+    static uint32_t ScanTick = 0; // 上次搜索总线时刻, 毫秒
+    static uint32_t ShowTick = 0; // 当前传感器开始显示的时刻, 毫秒
+    static uint8_t Fault;         // 总线无应答
+    static uint8_t Precise;       // 本次为12位转换
+    static uint8_t Index, Valid;  // 正在读取的传感器编号, 读数有效的传感器
+    uint8_t i;
 
-    if (FIsec)
-    {
-        RTC_EnterConfigMode();
-        RTC_SetAlarm(RTC_GetCounter() + FIsec);
-        RTC_WaitForLastTask();
-        RTC_ExitConfigMode();
-        RTC_ITConfig(RTC_IT_ALR, ENABLE);
-    }
-    else
+    TASK_BEGIN(Pt);
+    while (1)
     {
-        RTC_ITConfig(RTC_IT_ALR, DISABLE);
+        TASK_WAIT_UNTIL(Pt, !TempEnable);
+        Precise = TempPrecise || UIpage;
+        StartTick = Tick_Get();
+        Fault = DS18B20_SetResolution(Precise ? 12 : 10) || DS18B20_StartConvert();
+        if (!Fault)
+            TASK_WAIT_UNTIL(Pt, DS18B20_ConvertDone() || (Tick_Get() - StartTick >= DS18B20_ConvertTime()));
+        Valid = 0;
+        for (Index = 0; !Fault && (Index < DS18B20_Count()); Index++)
+        {
+            DS18B20_ReadStart(Index);
+            // 读暂存器的时隙由USART2中断收发; GPIO传输方式下ReadStart与每次重试都在调用内传输完毕(约10ms),
+            // 每次传输后让出, 使一次调度至多进行一次传输
+            TASK_YIELD(Pt);
+            TASK_WAIT_UNTIL(Pt, DS18B20_ReadDone());
+            if (!DS18B20_ReadEnd(&Temperature[Index]))
+                Valid |= 1 << Index;
+        }
+        TempValid = Valid;
+        if (Precise)
+            TempPrecise = 0;
+
+        if (((DS18B20_Count() == 0) || (Valid != (1 << DS18B20_Count()) - 1)) && (Tick_Get() - ScanTick >= 60000))
+        {
+            // 每次调度只执行一步: 搜索一个ROM、保存传感器表、写入配置或查询EEPROM写入完成
+            DS18B20_ScanStart();
+            TASK_YIELD(Pt);
+            TASK_WAIT_UNTIL(Pt, DS18B20_ScanStep());
+            ScanTick = Tick_Get();
+        }
+
+        // 多个传感器时主界面每3秒轮换显示下一个读数有效的传感器
+        if ((Tick_Get() - ShowTick >= 3000) || !(TempValid & (1 << TempShow)))
+        {
+            ShowTick = Tick_Get();
+            for (i = 1; i <= DS18B20_MAX; i++)
+                if (TempValid & (1 << ((TempShow + i) % DS18B20_MAX)))
+                {
+                    TempShow = (TempShow + i) % DS18B20_MAX;
+                    break;
+                }
+        }
+        TASK_WAIT_UNTIL(Pt, Tick_Get() - StartTick >= (Precise ? 1000 : 500));
     }
+    TASK_END(Pt);
 }
 
 /**
- * @brief  显示主界面
- * @param  SA_ST_M 投饵舵机状态/系统时间显示, 1:"正在投饵..." | 0:"时间:xx:xx:xx"
- *     @arg 1:饵料余量不足 | 0:饵料余量充足
- * @param  FI_M 投饵间隔时间, 数组, 时 分 秒
- * @param  BW_M 饵料不足警报标志
- *     @arg 1:饵料余量不足 | 0:饵料余量充足
- * @param WS_M WiFi连接状态标志
- *     @arg 1:WiFi未连接 | 0:WiFi已连接
- * @param TE_M 温度检测使能
- *     @arg 1:禁用温度检测 | 0:启用温度检测
+ * @brief  数据上传完成回调, 上传失败或超时时标记网络断开
+ * @param  Result 上传结果. ESP_OK | ESP_ERROR | ESP_TIMEOUT
  * @retval 无
  */
-void MainMenu(uint8_t SA_ST_M, uint8_t *FI_M, uint8_t BW_M, uint8_t WS_M, uint8_t TE_M)
+void PubDone(uint8_t Result)
 {
-    uint8_t TimeLine_Main = 1,
-            IntervalLine_Main = 3,
-            TmpLine = 5,
-            BaitLine = 7;
-
-    // "间隔:xx:xx:xx"
-    OLED_ShowCN(IntervalLine_Main, 1, 11);
-    OLED_ShowCN(IntervalLine_Main, 17, 12);
-    OLED_ShowChar(IntervalLine_Main, 33, ':', 8);
-    if (Feed_ED == '1')
-    {
-        OLED_ShowNum(IntervalLine_Main, 41, FI_M[0], 2, 8);
-        OLED_ShowChar(IntervalLine_Main, 57, ':', 8);
-        OLED_ShowNum(IntervalLine_Main, 65, FI_M[1], 2, 8);
-        OLED_ShowChar(IntervalLine_Main, 81, ':', 8);
-        OLED_ShowNum(IntervalLine_Main, 89, FI_M[2], 2, 8);
-    }
-    else
-    {
-        OLED_ShowCN(IntervalLine_Main, 41, 28);
-        OLED_ShowString(IntervalLine_Main, 57, "       ", 8);
-    }
+    if (Result != ESP_OK)
+        WiFiState = 1;
+}
+
+/**
+ * @brief  网络任务: 处理ESP8266收发, 每隔5秒向云平台上传一次数据;
+ *         平台下发使属性改变时立即上传, 使平台尽快看到设备的新状态.
+ *         定时上传前先请求一次12位温度转换, 至多等待2秒.
+ *         上传在后台进行, 结果由PubDone处理; 上一次上传尚未结束时稍后重试
+ * @param  Pt 任务断点
+ * @retval TASK_WAITING | TASK_ENDED
+ */
+uint8_t Task_Network(Task_Pt *Pt)
+{
+    static uint32_t PubTick; // 上一次上传时刻, 毫秒
+    static uint8_t Changed;  // 待上报的属性变化
+    uint8_t New;
 
-    // 饵料不足提醒
-    if (BW_M)
+    Esp_Poll();
+    New = Esp_GetChanged();
+    // 平台修改了投饵间隔: 保存并按新间隔重设闹钟(饵料不足时不启用)
+    if (New & ESP_CHANGED_INTERVAL)
     {
-        // "饵料不足(xxx)". xxx为累计投饵次数
-        OLED_ShowCN(BaitLine, 1, 10);
-        OLED_ShowCN(BaitLine, 17, 15);
-        OLED_ShowCN(BaitLine, 33, 16);
-        OLED_ShowCN(BaitLine, 49, 17);
-        OLED_ShowChar(BaitLine, 65, '(', 8);
-        OLED_ShowNum(BaitLine, 73, FeedCount, 3, 8);
-        OLED_ShowChar(BaitLine, 97, ')', 8);
+        MyRTC_SaveInterval(FeedInterval);
+        if (!BaitWarning)
+            MyRTC_SetAlarm(FeedInterval);
     }
+    // 平台修改了UTC偏移: 本地时间与投饵时刻随之改变
+    if ((New & ESP_CHANGED_OFFSET) && (Esp_GetUtcOffset() != MyRTC_GetOffset()))
+        MyRTC_SetOffset(Esp_GetUtcOffset());
     else
+        New &= ~ESP_CHANGED_OFFSET;
+    Changed |= New;
+
+    TASK_BEGIN(Pt);
+    PubTick = Tick_Get();
+    while (1)
     {
-        // "计次:xxx"
-        OLED_ShowCN(BaitLine, 1, 22);
-        OLED_ShowCN(BaitLine, 17, 23);
-        OLED_ShowChar(BaitLine, 33, ':', 8);
-        OLED_ShowNum(BaitLine, 41, FeedCount, 3, 8);
-        OLED_ShowString(BaitLine, 65, "     ", 8);
+        TASK_WAIT_UNTIL(Pt, Changed || (Tick_Get() - PubTick >= 5000));
+        if (!Changed)
+        {
+            TempPrecise = 1;
+            TASK_WAIT_UNTIL(Pt, !TempPrecise || Changed || (Tick_Get() - PubTick >= 7000));
+        }
+        TASK_WAIT_UNTIL(Pt, (WiFiState != 0) || !Esp_PUB(FeedCount, Temperature, TempValid, Feed_ED, FeedInterval, &DS18B20_Stat, MyRTC_GetOffset(), PubDone));
+        PubTick = Tick_Get();
+        Changed = 0;
     }
+    TASK_END(Pt);
+}
 
-    // WiFi连接状态图标
-    if (!WS_M)
-        // WiFi已连接
-        OLED_ShowCN(7, 112, 13);
-    else
-        // WiFi未连接
-        OLED_ShowCN(7, 112, 14);
+static uint8_t SntpResult; // 网络时间查询结果, ESP_OK/ESP_ERROR/ESP_TIMEOUT, 0xFF表示查询中
 
-    // 温度检测
-    if (!TE_M)
+static void SntpDone(uint8_t Result)
+{
+    SntpResult = Result;
+}
+
+/**
+ * @brief  校时任务: 联网后查询ESP8266的网络时间并校准RTC, 此后每小时一次;
+ *         模块尚未取得网络时间或查询失败时10秒后重试
+ * @param  Pt 任务断点
+ * @retval TASK_WAITING | TASK_ENDED
+ */
+uint8_t Task_Clock(Task_Pt *Pt)
+{
+    TASK_BEGIN(Pt);
+    while (1)
     {
-        if (!DS18B20_Reset())
+        TASK_WAIT_UNTIL(Pt, WiFiState == 0);
+        SntpResult = 0xFF;
+        TASK_WAIT_UNTIL(Pt, !Esp_SNTP(SntpDone));
+        TASK_WAIT_UNTIL(Pt, SntpResult != 0xFF);
+        if ((SntpResult == ESP_OK) && Esp_GetSntpTime())
         {
-            Temperature = DS18B20_ReadTemp();
-            // "温度℃:xxx.x"
-            OLED_ShowCN(TmpLine, 1, 0);
-            OLED_ShowCN(TmpLine, 17, 1);
-            OLED_ShowCN(TmpLine, 33, 2);
-            OLED_ShowChar(TmpLine, 49, ':', 8);
-            OLED_ShowString(TmpLine, 97, "  ", 8);
-            if (Temperature >= 0)
-                OLED_ShowFloat(TmpLine, 57, Temperature, 3, 1, 8);
-            else
-                OLED_ShowFloat(TmpLine, 57, Temperature, 2, 1, 8);
-            Delay_ms(5);
+            MyRTC_Sync(Esp_GetSntpTime());
+            TASK_DELAY(Pt, 3600000);
         }
         else
-        {
-            // "温度传感器断开"
-            OLED_ShowCN(TmpLine, 1, 0);
-            OLED_ShowCN(TmpLine, 17, 1);
-            OLED_ShowCN(TmpLine, 33, 3);
-            OLED_ShowCN(TmpLine, 49, 4);
-            OLED_ShowCN(TmpLine, 65, 5);
-            OLED_ShowCN(TmpLine, 81, 6);
-            OLED_ShowCN(TmpLine, 97, 7);
-        }
+            TASK_DELAY(Pt, 10000);
     }
+    TASK_END(Pt);
+}
 
-    uint16_t *SysTime;
+/**
+ * @brief  投饵任务: 检测饵料余量; 闹钟到时执行一次投饵动作,
+ *         舵机翻转2秒后回到接料位置, 再等待1秒, 等待期间其他任务照常运行.
+ *         投饵时刻按固定间隔排定(见MyRTC), 投饵期间闹钟保持开启, 不随投饵耗时推迟;
+ *         投饵期间再次到时只重复置位Servoflag, 不会重复投饵
+ * @param  Pt 任务断点
+ * @retval TASK_WAITING | TASK_ENDED
+ */
+uint8_t Task_Feeder(Task_Pt *Pt)
+{
+    // 闹钟到时, 启动投饵
+    if (MyRTC_GetAlarm())
+        Servoflag = 1;
 
-    if (!SA_ST_M)
+    // 饵料不足
+    if (Bait_Low())
     {
-        // 显示RTC时间
-        SysTime = MyRTC_ReadTime();
-        // "时间:xx:xx:xx"
-        OLED_ShowCN(TimeLine_Main, 1, 8);
-        OLED_ShowCN(TimeLine_Main, 17, 11);
-        OLED_ShowChar(TimeLine_Main, 33, ':', 8);
-        OLED_ShowNum(TimeLine_Main, 41, SysTime[3], 2, 8);
-        OLED_ShowChar(TimeLine_Main, 57, ':', 8);
-        OLED_ShowNum(TimeLine_Main, 65, SysTime[4], 2, 8);
-        OLED_ShowChar(TimeLine_Main, 81, ':', 8);
-        OLED_ShowNum(TimeLine_Main, 89, SysTime[5], 2, 8);
+        if (!BaitWarning)
+            MyRTC_AlarmOff();
+        BaitWarning = 1;
     }
     else
     {
-        // "正在投饵..."
-        OLED_ShowCN(1, 1, 20);
-        OLED_ShowCN(1, 17, 21);
-        OLED_ShowCN(1, 33, 9);
-        OLED_ShowCN(1, 49, 10);
-        OLED_ShowString(1, 65, "...   ", 8);
+        // 饵料由不足转充足,重置投饵计次,启用定时投饵
+        if (BaitWarning)
+        {
+            MyRTC_SetAlarm(FeedInterval);
+            FeedCount = 0;
+        }
+        BaitWarning = 0;
+    }
+
+    TASK_BEGIN(Pt);
+    while (1)
+    {
+        TASK_WAIT_UNTIL(Pt, Servoflag);
+        // 自动投饵已禁用
+        if (Feed_ED != '1')
+        {
+            Servoflag = 0;
+            continue;
+        }
+
+        FeedCount++;
+        Servo_SetAngle(180);
+        TASK_DELAY(Pt, 2000);
+        Servo_SetAngle(0);
+        TASK_DELAY(Pt, 1000);
+        Servoflag = 0;
     }
+    TASK_END(Pt);
 }
 
-/**
- * @brief  显示设置界面
- * @param SysTime 显示的待修改时间值, 数组, 时 分 秒
- * @param FI_S 投饵间隔时间, 数组, 时 分 秒
- * @retval 无
+/*
+ * 界面控件表. 各控件的位置与原逐字绘制的版面相同;
+ * 同一位置上互斥的内容(如时间与"正在投饵...")用同一文字控件的不同取值, 或由绑定值隐藏其中一个控件.
  */
-void SetMenu(uint16_t *SysTime, uint8_t *FI_S)
+
+static const uint8_t Text_Time[] = {UI_CN(8), UI_CN(11), ':', 0};                                          // "时间:"
+static const uint8_t Text_Feeding[] = {UI_CN(20), UI_CN(21), UI_CN(9), UI_CN(10), '.', '.', '.', 0};      // "正在投饵..."
+static const uint8_t Text_Interval[] = {UI_CN(11), UI_CN(12), ':', 0};                                     // "间隔:"
+static const uint8_t Text_Off[] = {UI_CN(28), 0};                                                          // "关"
+static const uint8_t Text_Temp[] = {UI_CN(0), UI_CN(1), UI_CN(2), ':', 0};                                 // "温度℃:"
+static const uint8_t Text_TempLost[] = {UI_CN(0), UI_CN(1), UI_CN(3), UI_CN(4), UI_CN(5), UI_CN(6), UI_CN(7), 0}; // "温度传感器断开"
+static const uint8_t Text_Count[] = {UI_CN(22), UI_CN(23), ':', 0};                                        // "计次:"
+static const uint8_t Text_BaitLow[] = {UI_CN(10), UI_CN(15), UI_CN(16), UI_CN(17), '(', 0};               // "饵料不足("
+static const uint8_t Text_Paren[] = {')', 0};
+static const uint8_t Text_WiFiOn[] = {UI_CN(13), 0};  // WiFi已连接图标
+static const uint8_t Text_WiFiOff[] = {UI_CN(14), 0}; // WiFi未连接图标
+
+static const uint8_t *const Text_TimeRow[] = {Text_Time, Text_Feeding};
+static const uint8_t *const Text_IntervalRow[] = {Text_Interval};
+static const uint8_t *const Text_OffRow[] = {0, Text_Off};
+static const uint8_t *const Text_TempRow[] = {Text_Temp, Text_TempLost};
+static const uint8_t *const Text_BaitRow[] = {Text_Count, Text_BaitLow};
+static const uint8_t *const Text_ParenRow[] = {0, Text_Paren};
+static const uint8_t *const Text_WiFiRow[] = {Text_WiFiOn, Text_WiFiOff};
+
+// 主界面绑定值
+static int32_t Main_TimeRow(void)
 {
-    uint8_t TimeLine_Set = 1;
-    uint8_t IntervalLine_Set = 5;
+    return Servoflag ? 1 : 0;
+}
 
-    if ((SetMenu_CurL == 1) || (SetMenu_CurL == 5))
-        OLED_ShowCN(SetMenu_CurL, SetMenu_CurC, 19);
-    else
-        OLED_ShowCN(SetMenu_CurL, SetMenu_CurC, 18);
-
-    // "时间:xx:xx:xx"
-    OLED_ShowCN(TimeLine_Set, 1, 8);
-    OLED_ShowCN(TimeLine_Set, 17, 11);
-    OLED_ShowChar(TimeLine_Set, 33, ':', 8);
-    OLED_ShowNum(TimeLine_Set, 41, SysTime[3], 2, 8);
-    OLED_ShowChar(TimeLine_Set, 57, ':', 8);
-    OLED_ShowNum(TimeLine_Set, 65, SysTime[4], 2, 8);
-    OLED_ShowChar(TimeLine_Set, 81, ':', 8);
-    OLED_ShowNum(TimeLine_Set, 89, SysTime[5], 2, 8);
-
-    // "间隔:xx:xx:xx"
-    OLED_ShowCN(IntervalLine_Set, 1, 11);
-    OLED_ShowCN(IntervalLine_Set, 17, 12);
-    OLED_ShowChar(IntervalLine_Set, 33, ':', 8);
-    OLED_ShowNum(IntervalLine_Set, 41, FI_S[0], 2, 8);
-    OLED_ShowChar(IntervalLine_Set, 57, ':', 8);
-    OLED_ShowNum(IntervalLine_Set, 65, FI_S[1], 2, 8);
-    OLED_ShowChar(IntervalLine_Set, 81, ':', 8);
-    OLED_ShowNum(IntervalLine_Set, 89, FI_S[2], 2, 8);
+static int32_t Main_Time(void)
+{
+    Calendar_TypeDef SysTime;
+
+    if (Servoflag)
+        return UI_HIDE;
+    MyRTC_GetTime(&SysTime);
+    return SysTime.Hour * 10000 + SysTime.Minute * 100 + SysTime.Second;
 }
 
-int main(void)
+static int32_t Main_Interval(void)
 {
-    OLED_Init();
+    if (Feed_ED != '1')
+        return UI_HIDE;
+    return FeedInterval[0] * 10000 + FeedInterval[1] * 100 + FeedInterval[2];
+}
 
-    // "正在启动..."
-    OLED_Clear();
-    OLED_ShowCN(1, 1, 20);
-    OLED_ShowCN(1, 17, 21);
-    OLED_ShowCN(1, 33, 24);
-    OLED_ShowCN(1, 49, 25);
-    OLED_ShowString(1, 65, "...   ", 8);
+static int32_t Main_Off(void)
+{
+    return (Feed_ED != '1') ? 1 : 0;
+}
 
-    Key_Init();
-    DS18B20_Init();
-    MyUSART_Init();
+static int32_t Main_TempRow(void)
+{
+    if (TempEnable)
+        return UI_HIDE;
+    return (TempValid & (1 << TempShow)) ? 0 : 1;
+}
 
-    MyRTC_Init();
-    MyRTC_SetAlarm();
+static int32_t Main_Temp(void)
+{
+    if (TempEnable || !(TempValid & (1 << TempShow)))
+        return UI_HIDE;
+    return (Temperature[TempShow] + ((Temperature[TempShow] < 0) ? -5 : 5)) / 10; // 0.01℃ -> 0.1℃, 四舍五入
+}
 
-    Servo_Init();
-    Servo_SetAngle(0); // 舵机复位(接料位置)
+static int32_t Main_TempNo(void)
+{
+    // 多个传感器读数有效时显示当前传感器编号(从1开始)
+    if (TempEnable || !(TempValid & (1 << TempShow)) || !(TempValid & (TempValid - 1)))
+        return UI_HIDE;
+    return TempShow + 1;
+}
 
-    //"(正在)配网(...)"
-    OLED_ShowCN(1, 33, 26);
-    OLED_ShowCN(1, 49, 27);
-    OLED_ShowString(3, 1, "log:-", 8);
-    uint8_t netflag = 1, timeout = 1;
-    do
-    {
-        OLED_ShowNum(3, 49, timeout, 1, 8);
-        netflag = esp_Init();
-        OLED_ShowNum(3, 33, netflag, 1, 8);
-        if (timeout++ >= 3)
-        {
-            OLED_ShowString(3, 33, "TimeOut", 8);
-            Delay_ms(500);
-            break;
-        }
-    } while (netflag); // 连接阿里云, 连接失败超过3次自动放弃
-    if (netflag)
-        WiFiState = 1;
-    else
-        WiFiState = 0;
+static int32_t Main_BaitRow(void)
+{
+    return BaitWarning;
+}
 
-    while (1)
-    {
-        // 每隔5秒向云平台上传一次数据
-        if ((Tuplaod > 5) && (WiFiState == 0))
-        {
-            RTC_ITConfig(RTC_IT_SEC, DISABLE);
-            if (Esp_PUB(FeedCount, (uint8_t)Temperature, Feed_ED, FeedInterval))
-            {
-                WiFiState = 1;
-            }
-            Tuplaod = 0;
-            RTC_ITConfig(RTC_IT_SEC, ENABLE);
-        }
+static int32_t Main_Count(void)
+{
+    return BaitWarning ? UI_HIDE : FeedCount;
+}
 
-        // 判断投饵使能状态
-        if (Feed_ED == '1')
-        {
-            // 执行投饵
-            if (Servoflag)
-            {
-                RTC_ITConfig(RTC_IT_SEC, DISABLE);
-                RTC_ITConfig(RTC_IT_ALR, DISABLE);
-                FeedCount++;
-                MainMenu(Servoflag, FeedInterval, BaitWarning, WiFiState, TempEnable);
-                Servo_SetAngle(180);
-                Delay_s(2);
-                Servo_SetAngle(0);
-                Delay_s(1);
-                Servoflag = 0;
-                MyRTC_SetAlarm();
-                RTC_ITConfig(RTC_IT_SEC, ENABLE);
-            }
-        }
-        else
-        {
-            Servoflag = 0;
-        }
+static int32_t Main_CountLow(void)
+{
+    return BaitWarning ? FeedCount : UI_HIDE;
+}
 
-        // 饵料不足
-        if (GPIO_ReadInputDataBit(GPIOB, GPIO_Pin_1) == 0)
-        {
-            BaitWarning = 1;
-            RTC_ITConfig(RTC_IT_ALR, DISABLE);
-        }
-        else
-        {
-            // 饵料由不足转充足,重置投饵计次,启用定时投饵
-            if (BaitWarning)
-            {
-                MyRTC_SetAlarm();
-                FeedCount = 0;
-            }
-            BaitWarning = 0;
-        }
+static int32_t Main_WiFi(void)
+{
+    return WiFiState;
+}
+
+static const UI_Widget Main_Widget[] = {
+    {UI_LABEL, 1, 1, 0, Text_TimeRow, Main_TimeRow},      // "时间:" | "正在投饵..."
+    {UI_TIME, 1, 41, 0, 0, Main_Time},                    // 系统时间
+    {UI_LABEL, 3, 1, 0, Text_IntervalRow, 0},             // "间隔:"
+    {UI_TIME, 3, 41, 0, 0, Main_Interval},                // 投饵间隔
+    {UI_LABEL, 3, 41, 0, Text_OffRow, Main_Off},          // 自动投饵已禁用
+    {UI_LABEL, 5, 1, 0, Text_TempRow, Main_TempRow},      // "温度℃:" | "温度传感器断开"
+    {UI_FIXED, 5, 57, 3, 0, Main_Temp},                   // 温度
+    {UI_NUM, 5, 105, 1, 0, Main_TempNo},                  // 传感器编号
+    {UI_LABEL, 7, 1, 0, Text_BaitRow, Main_BaitRow},      // "计次:" | "饵料不足("
+    {UI_NUM, 7, 41, 3, 0, Main_Count},                    // 投饵计次
+    {UI_NUM, 7, 73, 3, 0, Main_CountLow},                 // 饵料不足时的投饵计次
+    {UI_LABEL, 7, 97, 0, Text_ParenRow, Main_BaitRow},    // ")"
+    {UI_LABEL, 7, 112, 0, Text_WiFiRow, Main_WiFi},       // WiFi连接状态图标
+};
+const UI_Screen UI_MainScreen = {Main_Widget, sizeof(Main_Widget) / sizeof(Main_Widget[0])};
 
-        uint16_t *TempT; // 系统时间临时变量. 0:年 | 1:月 | 2:日 | 3:时 | 4:分 | 5:秒
-        uint32_t TTT;   // 用于判断处于设置界面时系统时间是否被更改
-        uint8_t *TempFI; // 投饵间隔临时变量. 0:时 | 1:分 | 2:秒
-        switch (KeyNum)
+// 设置界面绑定值
+static int32_t Set_Cursor(void)
+{
+    // 行1/5右侧为选择行的箭头, 行3/7为数字下方的箭头
+    uint8_t Glyph = ((SetMenu_CurL == 1) || (SetMenu_CurL == 5)) ? 19 : 18;
+    return UI_CURSOR_AT(Glyph, SetMenu_CurL, SetMenu_CurC);
+}
+
+static int32_t Set_Time(void)
+{
+    return TempT.Hour * 10000 + TempT.Minute * 100 + TempT.Second;
+}
+
+static int32_t Set_Interval(void)
+{
+    return TempFI[0] * 10000 + TempFI[1] * 100 + TempFI[2];
+}
+
+static const uint8_t *const Text_TimeLabel[] = {Text_Time};
+
+static const UI_Widget Set_Widget[] = {
+    {UI_CURSOR, 0, 0, 0, 0, Set_Cursor},             // 光标
+    {UI_LABEL, 1, 1, 0, Text_TimeLabel, 0},          // "时间:"
+    {UI_TIME, 1, 41, 0, 0, Set_Time},                // 待修改的系统时间
+    {UI_LABEL, 5, 1, 0, Text_IntervalRow, 0},        // "间隔:"
+    {UI_TIME, 5, 41, 0, 0, Set_Interval},            // 待修改的投饵间隔
+};
+const UI_Screen UI_SetScreen = {Set_Widget, sizeof(Set_Widget) / sizeof(Set_Widget[0])};
+
+// 诊断界面: 温度传感器总线统计, 计数只显示低6位
+static const uint8_t Text_Sensors[] = "Sensors:";
+static const uint8_t Text_CrcErr[] = "CRC err:";
+static const uint8_t Text_NoResp[] = "No resp:";
+static const uint8_t Text_Retry[] = "Retries:";
+static const uint8_t Text_Slash[] = "/";
+static const uint8_t *const Text_SensorsLabel[] = {Text_Sensors};
+static const uint8_t *const Text_CrcErrLabel[] = {Text_CrcErr};
+static const uint8_t *const Text_NoRespLabel[] = {Text_NoResp};
+static const uint8_t *const Text_RetryLabel[] = {Text_Retry};
+static const uint8_t *const Text_SlashLabel[] = {Text_Slash};
+
+static int32_t Diag_Sensors(void)
+{
+    return DS18B20_Count();
+}
+
+static int32_t Diag_Valid(void)
+{
+    uint8_t i, n = 0;
+
+    for (i = 0; i < DS18B20_MAX; i++)
+        n += (TempValid >> i) & 0x01;
+    return n;
+}
+
+static int32_t Diag_Crc(void)
+{
+    return DS18B20_Stat.Crc % 1000000;
+}
+
+static int32_t Diag_NoResp(void)
+{
+    return DS18B20_Stat.Presence % 1000000;
+}
+
+static int32_t Diag_Retry(void)
+{
+    return DS18B20_Stat.Retry % 1000000;
+}
+
+static const UI_Widget Diag_Widget[] = {
+    {UI_LABEL, 1, 1, 0, Text_SensorsLabel, 0},       // "Sensors:"
+    {UI_NUM, 1, 73, 1, 0, Diag_Valid},               // 读数有效的传感器数
+    {UI_LABEL, 1, 81, 0, Text_SlashLabel, 0},        // "/"
+    {UI_NUM, 1, 89, 1, 0, Diag_Sensors},             // 已分配编号的传感器数
+    {UI_LABEL, 3, 1, 0, Text_CrcErrLabel, 0},        // "CRC err:"
+    {UI_NUM, 3, 73, 6, 0, Diag_Crc},                 // CRC校验失败次数
+    {UI_LABEL, 5, 1, 0, Text_NoRespLabel, 0},        // "No resp:"
+    {UI_NUM, 5, 73, 6, 0, Diag_NoResp},              // 无应答次数
+    {UI_LABEL, 7, 1, 0, Text_RetryLabel, 0},         // "Retries:"
+    {UI_NUM, 7, 73, 6, 0, Diag_Retry},               // 重试次数
+};
+const UI_Screen UI_DiagScreen = {Diag_Widget, sizeof(Diag_Widget) / sizeof(Diag_Widget[0])};
+
+/**
+ * @brief  按键任务: 处理按键, 切换界面与修改设置
+ * @param  Pt 任务断点
+ * @retval TASK_ENDED
+ */
+uint8_t Task_Input(Task_Pt *Pt)
+{
+    uint8_t Event;
+
+    (void)Pt; // 单次执行完毕, 不使用断点
+
+    while ((Event = Key_GetEvent()) != 0)
+    {
+        // 只响应按下; 方向键按住时自动连发, 菜单键与返回键不连发
+        if ((KEY_TYPE(Event) != KEY_PRESS) &&
+            !((KEY_TYPE(Event) == KEY_REPEAT) && (KEY_CODE(Event) != 5) && (KEY_CODE(Event) != 1)))
+            continue;
+
+        switch (KEY_CODE(Event))
         {
         case 5: // 菜单、确定键
-            OLED_Clear();
+            if (UIpage == 2)
+                break;
             if (!UIpage) // 主界面 -> 设置界面
             {
-                RTC_ITConfig(RTC_IT_ALR, DISABLE); // 禁用闹钟中断(停止自动投饵)
-                TempT = MyRTC_ReadTime();
-                TTT = TempT[3] * 10000 + TempT[4] * 100 + TempT[5];
+                MyRTC_AlarmOff(); // 禁用闹钟中断(停止自动投饵)
+                MyRTC_GetTime(&TempT);
+                TTT = TempT.Hour * 10000 + TempT.Minute * 100 + TempT.Second;
                 TempFI = FeedInterval;
                 SetMenu_CurL = 1;
                 SetMenu_CurC = 112;
-                SetMenu(TempT, TempFI);
                 UIpage = 1;
             }
             else // 保存改动, 设置界面 -> 主界面
             {
-                if (TempT[3] * 10000 + TempT[4] * 100 + TempT[5] != TTT)
-                    MyRTC_SetTime(TempT);
-                for (uint8_t j = 0x00, i = 0; i <= 2; i++, j += 0x04)
-                {
-                    FeedInterval[i] = TempFI[i];
-                    BKP_WriteBackupRegister(BKP_DR2 + j, FeedInterval[i]);
-                }
-                MyRTC_SetAlarm();
+                if ((uint32_t)(TempT.Hour * 10000 + TempT.Minute * 100 + TempT.Second) != TTT)
+                    MyRTC_SetTime(&TempT);
+                MyRTC_SaveInterval(TempFI);
+                MyRTC_SetAlarm(FeedInterval); // 重新读取投饵间隔并设置闹钟
                 Servoflag = 0;
-                MainMenu(Servoflag, FeedInterval, BaitWarning, WiFiState, TempEnable);
                 UIpage = 0;
             }
-            KeyNum = 0;
             break;
         case 4: // Left键
-            if (UIpage)
+            if (UIpage == 1)
             {
-                OLED_Clear();
                 if (SetMenu_CurL == 1)
                 {
                     SetMenu_CurL = 3;
@@ -371,12 +507,10 @@ int main(void)
                     SetMenu_CurC = 89;
                 }
             }
-            KeyNum = 0;
             break;
         case 6: // Right键
-            if (UIpage)
+            if (UIpage == 1)
             {
-                OLED_Clear();
                 if (SetMenu_CurL == 3)
                 {
                     SetMenu_CurC += 24;
@@ -396,12 +530,12 @@ int main(void)
                     }
                 }
             }
-            KeyNum = 0;
             break;
         case 8: // Up键
-            if (UIpage)
+            if (UIpage == 2) // 诊断界面 -> 主界面
+                UIpage = 0;
+            else if (UIpage == 1)
             {
-                OLED_Clear();
                 if (SetMenu_CurC == 112)
                 {
                     SetMenu_CurL = 1;
@@ -410,48 +544,60 @@ int main(void)
                 {
                     // 秒
                     if (SetMenu_CurC == 89)
-                        if (TempT[5] < 59)
-                            TempT[5] += 1;
+                    {
+                        if (TempT.Second < 59)
+                            TempT.Second += 1;
                         else
-                            TempT[5] = 0;
+                            TempT.Second = 0;
+                    }
                     // 分
                     if (SetMenu_CurC == 65)
-                        if (TempT[4] < 59)
-                            TempT[4] += 1;
+                    {
+                        if (TempT.Minute < 59)
+                            TempT.Minute += 1;
                         else
-                            TempT[4] = 0;
+                            TempT.Minute = 0;
+                    }
                     // 时
                     if (SetMenu_CurC == 41)
-                        if (TempT[3] < 23)
-                            TempT[3] += 1;
+                    {
+                        if (TempT.Hour < 23)
+                            TempT.Hour += 1;
                         else
-                            TempT[3] = 0;
+                            TempT.Hour = 0;
+                    }
                 }
                 else if (SetMenu_CurL == 7)
                 {
                     if (SetMenu_CurC == 89)
+                    {
                         if (TempFI[2] < 59)
                             TempFI[2] += 1;
                         else
                             TempFI[2] = 0;
+                    }
                     if (SetMenu_CurC == 65)
+                    {
                         if (TempFI[1] < 59)
                             TempFI[1] += 1;
                         else
                             TempFI[1] = 0;
+                    }
                     if (SetMenu_CurC == 41)
+                    {
                         if (TempFI[0] < 23)
                             TempFI[0] += 1;
                         else
                             TempFI[0] = 0;
+                    }
                 }
             }
-            KeyNum = 0;
             break;
         case 2: // Down键
-            if (UIpage)
+            if (UIpage == 0) // 主界面 -> 诊断界面
+                UIpage = 2;
+            else if (UIpage == 1)
             {
-                OLED_Clear();
                 if (SetMenu_CurC == 112)
                 {
                     SetMenu_CurL = 5;
@@ -459,76 +605,140 @@ int main(void)
                 else if (SetMenu_CurL == 3)
                 {
                     if (SetMenu_CurC == 89)
-                        if (TempT[5] > 0)
-                            TempT[5] -= 1;
+                    {
+                        if (TempT.Second > 0)
+                            TempT.Second -= 1;
                         else
-                            TempT[5] = 59;
+                            TempT.Second = 59;
+                    }
                     if (SetMenu_CurC == 65)
-                        if (TempT[4] > 0)
-                            TempT[4] -= 1;
+                    {
+                        if (TempT.Minute > 0)
+                            TempT.Minute -= 1;
                         else
-                            TempT[4] = 59;
+                            TempT.Minute = 59;
+                    }
                     if (SetMenu_CurC == 41)
-                        if (TempT[3] > 0)
-                            TempT[3] -= 1;
+                    {
+                        if (TempT.Hour > 0)
+                            TempT.Hour -= 1;
                         else
-                            TempT[3] = 23;
+                            TempT.Hour = 23;
+                    }
                 }
                 else if (SetMenu_CurL == 7)
                 {
                     if (SetMenu_CurC == 89)
+                    {
                         if (TempFI[2] > 0)
                             TempFI[2] -= 1;
                         else
                             TempFI[2] = 59;
+                    }
                     if (SetMenu_CurC == 65)
+                    {
                         if (TempFI[1] > 0)
                             TempFI[1] -= 1;
                         else
                             TempFI[1] = 59;
+                    }
                     if (SetMenu_CurC == 41)
+                    {
                         if (TempFI[0] > 0)
                             TempFI[0] -= 1;
                         else
                             TempFI[0] = 23;
+                    }
                 }
             }
-            KeyNum = 0;
             break;
         case 1: // 返回键
-            OLED_Clear();
-            MyRTC_SetAlarm();
-            MainMenu(Servoflag, FeedInterval, BaitWarning, WiFiState, TempEnable);
+            if (UIpage != 2)
+                MyRTC_SetAlarm(FeedInterval);
             UIpage = 0;
-            KeyNum = 0;
-            break;
-        default: // 保持当前界面
-            if (!UIpage)
-                MainMenu(Servoflag, FeedInterval, BaitWarning, WiFiState, TempEnable);
-            else
-                SetMenu(TempT, TempFI);
             break;
         }
     }
+    return TASK_ENDED;
+}
+
+/**
+ * @brief  界面任务: 切换到当前界面, 只重绘取值有变化的控件, 仅将有改动的显存区间发送到屏幕
+ * @param  Pt 任务断点
+ * @retval TASK_ENDED
+ */
+uint8_t Task_UI(Task_Pt *Pt)
+{
+    static const UI_Screen *const Page[] = {&UI_MainScreen, &UI_SetScreen, &UI_DiagScreen};
+
+    (void)Pt; // 单次执行完毕, 不使用断点
+
+    UI_Show(Page[UIpage]);
+    UI_Update();
+    OLED_Refresh();
+    return TASK_ENDED;
 }
 
-// RTC中断
-void RTC_IRQHandler(void)
+int main(void)
 {
-    // 闹钟中断
-    if (RTC_GetITStatus(RTC_IT_ALR) != RESET)
+    Delay_Init(); // DWT微秒延时及SysTick毫秒时基
+    OLED_Init();
+
+    // "正在启动..."
+    OLED_Clear();
+    OLED_ShowCN(1, 1, 20);
+    OLED_ShowCN(1, 17, 21);
+    OLED_ShowCN(1, 33, 24);
+    OLED_ShowCN(1, 49, 25);
+    OLED_ShowString(1, 65, "...   ", 8);
+    OLED_RefreshSync();
+
+    Key_Init();
+    Bait_Init();
+    DS18B20_Init();
+    MyUSART_Init();
+
+    MyRTC_Init();
+    MyRTC_SetAlarm(FeedInterval);
+
+    Servo_Init();
+    Servo_SetAngle(0); // 舵机复位(接料位置)
+
+    //"(正在)配网(...)"
+    OLED_ShowCN(1, 33, 26);
+    OLED_ShowCN(1, 49, 27);
+    OLED_ShowString(3, 1, "log:-", 8);
+    uint8_t netflag = 1, timeout = 1;
+    do
     {
-        Servoflag = 1;
-        RTC_ClearITPendingBit(RTC_IT_ALR);
-        MyRTC_SetAlarm();
-    }
+        OLED_ShowNum(3, 49, timeout, 1, 8);
+        OLED_RefreshSync();
+        netflag = esp_Init();
+        OLED_ShowNum(3, 33, netflag, 1, 8);
+        OLED_RefreshSync();
+        if (timeout++ >= 3)
+        {
+            OLED_ShowString(3, 33, "TimeOut", 8);
+            OLED_RefreshSync();
+            Delay_ms(500);
+            break;
+        }
+    } while (netflag); // 连接阿里云, 连接失败超过3次自动放弃
+    if (netflag)
+        WiFiState = 1;
+    else
+        WiFiState = 0;
+
+    Task_Add(Task_Input, 5, 0);
+    Task_Add(Task_Feeder, 10, 1);
+    Task_Add(Task_Network, 10, 2);
+    Task_Add(Task_Sensor, 20, 3);
+    Task_Add(Task_UI, 20, 4);
+    Task_Add(Task_Clock, 100, 5);
 
-    // 秒中断
-    if (RTC_GetITStatus(RTC_IT_SEC) != RESET)
+    while (1)
     {
-        if (Tuplaod++ > 20)
-            Tuplaod = 0;
+        Task_Run();
     }
-    RTC_ClearITPendingBit(RTC_IT_SEC | RTC_IT_OW);
-    RTC_WaitForLastTask();
 }
+
@@ -127,14 +127,7 @@ void PendSV_Handler(void)
 {
 }
 
-/**
-  * @brief  This function handles SysTick Handler.
-  * @param  None
-  * @retval None
-  */
-void SysTick_Handler(void)
-{
-}
+/* SysTick_Handler is implemented in System/Tick.c (1 ms timebase). */
 
 /******************************************************************************/
 /*                 STM32F10x Peripherals Interrupt Handlers                   */